@@ -0,0 +1,221 @@
+#include "CoreHost.h"
+#include "LogosCoreGate.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QPluginLoader>
+#include <QStandardPaths>
+#include <QTimer>
+
+extern "C" {
+    void logos_core_set_plugins_dir(const char* plugins_dir);
+    void logos_core_add_plugins_dir(const char* plugins_dir);
+    void logos_core_start();
+    void logos_core_cleanup();
+    char** logos_core_get_loaded_plugins();
+    int logos_core_load_plugin(const char* plugin_name);
+    char* logos_core_process_plugin(const char* plugin_path);
+    char* logos_core_get_module_stats();
+}
+
+namespace {
+
+QString pluginExtension()
+{
+#if defined(Q_OS_MAC)
+    return ".dylib";
+#elif defined(Q_OS_WIN)
+    return ".dll";
+#else // Linux and others
+    return ".so";
+#endif
+}
+
+}
+
+CoreHost::CoreHost(const QString& modulesDir, QObject* parent)
+    : QObject(parent)
+    , m_modulesDir(QDir::cleanPath(modulesDir))
+    , m_statsTimer(nullptr)
+    , m_started(false)
+{
+    LogosCoreGate::publish();
+}
+
+QString CoreHost::defaultModulesDirectory()
+{
+    return QDir::cleanPath(QCoreApplication::applicationDirPath() + "/../modules");
+}
+
+void CoreHost::configure()
+{
+    QMutexLocker locker(&LogosCoreGate::mutex());
+    logos_core_set_plugins_dir(m_modulesDir.toUtf8().constData());
+
+    const QString userModulesDir = userModulesDirectory();
+    if (!userModulesDir.isEmpty()) {
+        logos_core_add_plugins_dir(userModulesDir.toUtf8().constData());
+    }
+}
+
+QString CoreHost::userModulesDirectory() const
+{
+    QFileInfo bundledDirInfo(m_modulesDir);
+    if (bundledDirInfo.isWritable()) {
+        return QString();
+    }
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/modules";
+}
+
+QString CoreHost::modulePath(const QString& name) const
+{
+    const QString fileName = name + "_plugin" + pluginExtension();
+    for (const QString& directory : {m_modulesDir, userModulesDirectory()}) {
+        if (directory.isEmpty()) {
+            continue;
+        }
+        const QString path = directory + "/" + fileName;
+        if (QFileInfo::exists(path)) {
+            return path;
+        }
+    }
+    return QString();
+}
+
+QStringList CoreHost::moduleDependencies(const QString& name) const
+{
+    const QString path = modulePath(name);
+    if (path.isEmpty()) {
+        return QStringList();
+    }
+    // QPluginLoader reads the embedded metadata without loading the library
+    const QJsonObject metadata = QPluginLoader(path).metaData().value("MetaData").toObject();
+    QStringList dependencies;
+    for (const QJsonValue& value : metadata.value("dependencies").toArray()) {
+        if (!value.toString().isEmpty()) {
+            dependencies << value.toString();
+        }
+    }
+    return dependencies;
+}
+
+void CoreHost::start()
+{
+    QMutexLocker locker(&LogosCoreGate::mutex());
+    logos_core_start();
+    m_started = true;
+}
+
+void CoreHost::cleanup()
+{
+    stopStatsSampling();
+    if (m_started) {
+        QMutexLocker locker(&LogosCoreGate::mutex());
+        logos_core_cleanup();
+        m_started = false;
+    }
+}
+
+bool CoreHost::loadModule(const QString& name)
+{
+    const QString pluginPath = modulePath(name);
+    QMutexLocker locker(&LogosCoreGate::mutex());
+    if (!pluginPath.isEmpty()) {
+        logos_core_process_plugin(pluginPath.toUtf8().constData());
+    }
+    return logos_core_load_plugin(name.toUtf8().constData());
+}
+
+QStringList CoreHost::loadModules(const QStringList& names)
+{
+    QStringList failed;
+    for (const QString& name : names) {
+        if (loadModule(name)) {
+            qInfo() << name << "plugin loaded.";
+        } else {
+            qWarning() << "Failed to load" << name << "plugin.";
+            failed << name;
+        }
+    }
+    return failed;
+}
+
+QStringList CoreHost::loadedModules()
+{
+    QStringList result;
+    QMutexLocker locker(&LogosCoreGate::mutex());
+    char** plugins = logos_core_get_loaded_plugins();
+    if (plugins) {
+        for (int i = 0; plugins[i] != nullptr; i++) {
+            result.append(plugins[i]);
+        }
+    }
+    return result;
+}
+
+void CoreHost::logLoadedModules() const
+{
+    const QStringList plugins = loadedModules();
+    if (plugins.isEmpty()) {
+        qInfo() << "No plugins loaded.";
+        return;
+    }
+    qInfo() << "Currently loaded plugins:";
+    for (const QString& plugin : plugins) {
+        qInfo() << "  -" << plugin;
+    }
+    qInfo() << "Total plugins:" << plugins.size();
+}
+
+QByteArray CoreHost::moduleStats()
+{
+    QMutexLocker locker(&LogosCoreGate::mutex());
+    return readModuleStats();
+}
+
+QByteArray CoreHost::readModuleStats()
+{
+    char* stats_json = logos_core_get_module_stats();
+    if (!stats_json) {
+        return QByteArray();
+    }
+    QByteArray stats(stats_json);
+    delete[] stats_json;
+    return stats;
+}
+
+void CoreHost::startStatsSampling(int intervalMs)
+{
+    if (!m_statsTimer) {
+        m_statsTimer = new QTimer(this);
+        connect(m_statsTimer, &QTimer::timeout, this, &CoreHost::sampleStats);
+    }
+    m_statsTimer->setTimerType(intervalMs >= 10000 ? Qt::VeryCoarseTimer : Qt::CoarseTimer);
+    m_statsTimer->start(intervalMs);
+}
+
+void CoreHost::stopStatsSampling()
+{
+    if (m_statsTimer) {
+        m_statsTimer->stop();
+    }
+}
+
+void CoreHost::sampleStats()
+{
+    // Runs on the GUI thread; while a module is loading, the next tick samples instead
+    if (!LogosCoreGate::mutex().tryLock()) {
+        return;
+    }
+    QByteArray stats = readModuleStats();
+    LogosCoreGate::mutex().unlock();
+    if (stats.isEmpty()) {
+        return;
+    }
+    m_lastStats = stats;
+    emit statsSampled(m_lastStats);
+}
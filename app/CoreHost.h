@@ -0,0 +1,73 @@
+#ifndef COREHOST_H
+#define COREHOST_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QTimer;
+
+// Drives logos_core for an app process: plugin directory setup, start, module
+// loading and periodic module stats sampling.
+//
+// Shared by the GUI app (main.cpp) and the headless host (headless_main.cpp), so
+// it only depends on QtCore. Its methods may be called from any thread; the
+// logos_core_* calls they make hold LogosCoreGate, which the constructor publishes
+// so the UI plugins' own core calls take the same lock.
+class CoreHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CoreHost(const QString& modulesDir, QObject* parent = nullptr);
+
+    // ../modules next to the executable
+    static QString defaultModulesDirectory();
+    QString modulesDirectory() const { return m_modulesDir; }
+
+    // Bundled modules directory, plus the user modules directory if the bundled one is read-only
+    void configure();
+    void start();
+    void cleanup();
+    bool isStarted() const { return m_started; }
+
+    // <name>_plugin.<ext> in the bundled or user modules directory, empty if not found
+    QString modulePath(const QString& name) const;
+    // "dependencies" from the module's plugin metadata, read without loading it
+    QStringList moduleDependencies(const QString& name) const;
+
+    // Processes and loads <modulesDir>/<name>_plugin.<ext>; blocks other core calls
+    // until the module's host is up
+    bool loadModule(const QString& name);
+    // Returns the names that failed to load
+    QStringList loadModules(const QStringList& names);
+
+    static QStringList loadedModules();
+    void logLoadedModules() const;
+
+    // Raw JSON from logos_core_get_module_stats(), empty if unavailable
+    static QByteArray moduleStats();
+
+    // Samples module stats every intervalMs; coarse timers are used for long intervals
+    void startStatsSampling(int intervalMs);
+    void stopStatsSampling();
+    // Skipped while another core call, such as a module load, holds the gate
+    void sampleStats();
+    QByteArray lastStats() const { return m_lastStats; }
+
+signals:
+    void statsSampled(const QByteArray& statsJson);
+
+private:
+    QString userModulesDirectory() const;
+    // Caller holds LogosCoreGate
+    static QByteArray readModuleStats();
+
+    QString m_modulesDir;
+    QTimer* m_statsTimer;
+    QByteArray m_lastStats;
+    bool m_started;
+};
+
+#endif // COREHOST_H
@@ -0,0 +1,119 @@
+#include "HeadlessStatusServer.h"
+#include "CoreHost.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QSaveFile>
+
+HeadlessStatusServer::HeadlessStatusServer(CoreHost* coreHost, QObject* parent)
+    : QObject(parent)
+    , m_coreHost(coreHost)
+    , m_server(nullptr)
+{
+    m_uptime.start();
+}
+
+bool HeadlessStatusServer::listen(const QString& serverName)
+{
+    m_serverName = serverName;
+
+    // Only replace the socket if nobody is serving on it anymore
+    QLocalSocket probe;
+    probe.connectToServer(serverName);
+    if (probe.waitForConnected(500)) {
+        qWarning() << "HeadlessStatusServer: another host is already running on" << serverName;
+        return false;
+    }
+    QLocalServer::removeServer(serverName);
+
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &HeadlessStatusServer::onNewConnection);
+    if (!m_server->listen(serverName)) {
+        qWarning() << "HeadlessStatusServer: failed to listen on" << serverName << ":" << m_server->errorString();
+        return false;
+    }
+    qInfo() << "Status socket:" << m_server->fullServerName();
+    return true;
+}
+
+void HeadlessStatusServer::setStatsFile(const QString& path)
+{
+    if (m_statsFile.isEmpty() && !path.isEmpty()) {
+        connect(m_coreHost, &CoreHost::statsSampled, this, &HeadlessStatusServer::writeStatsFile);
+    }
+    m_statsFile = path;
+}
+
+QJsonObject HeadlessStatusServer::status() const
+{
+    QJsonObject status;
+    status["pid"] = QCoreApplication::applicationPid();
+    status["uptimeMs"] = m_uptime.elapsed();
+    status["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    status["modulesDir"] = m_coreHost->modulesDirectory();
+    status["coreStarted"] = m_coreHost->isStarted();
+    status["loadedModules"] = QJsonArray::fromStringList(CoreHost::loadedModules());
+    status["failedModules"] = QJsonArray::fromStringList(m_failedModules);
+
+    const QJsonDocument stats = QJsonDocument::fromJson(m_coreHost->lastStats());
+    if (stats.isArray()) {
+        status["stats"] = stats.array();
+    } else if (stats.isObject()) {
+        status["stats"] = stats.object();
+    }
+    return status;
+}
+
+void HeadlessStatusServer::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            if (!socket->canReadLine()) {
+                return;
+            }
+            const QByteArray command = socket->readLine().trimmed();
+            QByteArray reply;
+            if (command == "stats") {
+                reply = m_coreHost->lastStats();
+                if (reply.isEmpty()) {
+                    reply = "null";
+                }
+            } else if (command.isEmpty() || command == "status") {
+                reply = QJsonDocument(status()).toJson(QJsonDocument::Compact);
+            } else {
+                QJsonObject error;
+                error["error"] = QString("unknown command: %1").arg(QString::fromUtf8(command));
+                reply = QJsonDocument(error).toJson(QJsonDocument::Compact);
+            }
+            socket->write(reply + '\n');
+            socket->flush();
+            socket->disconnectFromServer();
+        });
+    }
+}
+
+void HeadlessStatusServer::writeStatsFile()
+{
+    if (m_statsFile.isEmpty()) {
+        return;
+    }
+    QDir().mkpath(QFileInfo(m_statsFile).absolutePath());
+    // Readers never see a partially written file
+    QSaveFile file(m_statsFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write stats file" << m_statsFile << ":" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(status()).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        qWarning() << "Failed to write stats file" << m_statsFile << ":" << file.errorString();
+    }
+}
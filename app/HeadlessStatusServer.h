@@ -0,0 +1,46 @@
+#ifndef HEADLESSSTATUSSERVER_H
+#define HEADLESSSTATUSSERVER_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class CoreHost;
+class QLocalServer;
+
+// Reports the state of a headless core host.
+//
+// Clients connect to the local socket, send one line ("status" or "stats") and get
+// one line of JSON back before the connection is closed. With a stats file set, the
+// status is also rewritten atomically after every stats sample.
+class HeadlessStatusServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeadlessStatusServer(CoreHost* coreHost, QObject* parent = nullptr);
+
+    // Fails if another host already answers on the socket
+    bool listen(const QString& serverName);
+    QString serverName() const { return m_serverName; }
+
+    void setStatsFile(const QString& path);
+    void setFailedModules(const QStringList& modules) { m_failedModules = modules; }
+
+    QJsonObject status() const;
+
+private:
+    void onNewConnection();
+    void writeStatsFile();
+
+    CoreHost* m_coreHost;
+    QLocalServer* m_server;
+    QString m_serverName;
+    QString m_statsFile;
+    QStringList m_failedModules;
+    QElapsedTimer m_uptime;
+};
+
+#endif // HEADLESSSTATUSSERVER_H
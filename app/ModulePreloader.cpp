@@ -0,0 +1,189 @@
+#include "ModulePreloader.h"
+#include "CoreHost.h"
+#include "LogosSettings.h"
+#include "StartupScheduler.h"
+#include <QDebug>
+#include <QMutexLocker>
+#include <QTimer>
+
+namespace {
+
+const QString kStepPrefix = QStringLiteral("preload.");
+
+QStringList cleanModuleList(const QStringList& modules)
+{
+    QStringList result;
+    for (const QString& module : modules) {
+        const QString name = module.trimmed();
+        if (!name.isEmpty() && !result.contains(name)) {
+            result << name;
+        }
+    }
+    return result;
+}
+
+}
+
+ModulePreloader::ModulePreloader(CoreHost* coreHost, QObject* parent)
+    : QObject(parent)
+    , m_coreHost(coreHost)
+    , m_scheduler(nullptr)
+    , m_afterFirstFrame(true)
+    , m_running(false)
+    , m_total(0)
+    , m_done(0)
+{
+}
+
+ModulePreloader::~ModulePreloader()
+{
+    // Waits for loads still running on worker threads
+    delete m_scheduler;
+}
+
+void ModulePreloader::configure(const QString& profile, const QStringList& modules, bool restoreSession)
+{
+    auto settings = LogosSettings::open();
+
+    QStringList requested;
+    const QString profileName = profile.isEmpty() ? settings->value("preload/profile").toString() : profile;
+    if (!profileName.isEmpty()) {
+        const QString key = "profiles/" + profileName;
+        if (settings->contains(key)) {
+            requested << settings->value(key).toStringList();
+        } else {
+            qWarning() << "Unknown preload profile" << profileName << "in" << LogosSettings::path();
+        }
+    }
+    if (restoreSession || settings->value("preload/restoreSession", false).toBool()) {
+        requested << settings->value("session/modules").toStringList();
+    }
+    requested << modules;
+    m_requested = cleanModuleList(requested);
+
+    m_afterFirstFrame = settings->value("preload/when", "firstFrame").toString() != "startup";
+
+    if (!m_requested.isEmpty()) {
+        qInfo() << "Modules to preload" << (m_afterFirstFrame ? "after the first frame:" : "at startup:")
+                << m_requested.join(", ");
+    }
+}
+
+void ModulePreloader::saveSession(const QStringList& modules)
+{
+    auto settings = LogosSettings::open();
+    settings->setValue("session/modules", modules);
+}
+
+void ModulePreloader::visit(const QString& module, const QSet<QString>& alreadyLoaded, QStringList& order,
+                            QSet<QString>& visiting, QSet<QString>& visited) const
+{
+    if (visited.contains(module) || alreadyLoaded.contains(module)) {
+        return;
+    }
+    if (visiting.contains(module)) {
+        qWarning() << "Dependency cycle through module" << module << "; loading it without waiting";
+        return;
+    }
+    visiting.insert(module);
+    for (const QString& dependency : m_coreHost->moduleDependencies(module)) {
+        visit(dependency, alreadyLoaded, order, visiting, visited);
+    }
+    visiting.remove(module);
+    visited.insert(module);
+    order << module;
+}
+
+QStringList ModulePreloader::loadOrder(const QSet<QString>& alreadyLoaded) const
+{
+    // Dependencies come before their dependents, as the scheduler requires
+    QStringList order;
+    QSet<QString> visiting;
+    QSet<QString> visited;
+    for (const QString& module : m_requested) {
+        visit(module, alreadyLoaded, order, visiting, visited);
+    }
+    return order;
+}
+
+void ModulePreloader::start()
+{
+    if (m_running || m_scheduler) {
+        return;
+    }
+
+    const QStringList loaded = CoreHost::loadedModules();
+    const QSet<QString> alreadyLoaded(loaded.begin(), loaded.end());
+    const QStringList order = loadOrder(alreadyLoaded);
+
+    m_total = order.size();
+    m_done = 0;
+    if (order.isEmpty()) {
+        QTimer::singleShot(0, this, [this]() { emit finished(QStringList(), QStringList()); });
+        return;
+    }
+
+    m_running = true;
+    m_scheduler = new StartupScheduler();
+    // The loads serialize on LogosCoreGate anyway
+    m_scheduler->setMaxThreadCount(1);
+    connect(m_scheduler, &StartupScheduler::stepFinished, this, &ModulePreloader::onStepFinished);
+
+    for (const QString& module : order) {
+        QStringList dependencies;
+        QStringList dependencySteps;
+        for (const QString& dependency : m_coreHost->moduleDependencies(module)) {
+            if (order.contains(dependency) && order.indexOf(dependency) < order.indexOf(module)) {
+                dependencies << dependency;
+                dependencySteps << kStepPrefix + dependency;
+            }
+        }
+        // Off the GUI thread, which only ever tries the gate
+        m_scheduler->addStep(kStepPrefix + module, StartupScheduler::Affinity::Worker, [this, module, dependencies]() {
+            loadModule(module, dependencies);
+        }, dependencySteps);
+    }
+
+    qInfo() << "Preloading" << m_total << "modules:" << order.join(", ");
+    m_scheduler->start();
+}
+
+void ModulePreloader::loadModule(const QString& module, const QStringList& dependencies)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString& dependency : dependencies) {
+            if (m_failed.contains(dependency)) {
+                qWarning() << "Not preloading" << module << "because its dependency" << dependency << "failed";
+                m_failed << module;
+                return;
+            }
+        }
+    }
+
+    const bool success = m_coreHost->loadModule(module);
+    QMutexLocker locker(&m_mutex);
+    (success ? m_loaded : m_failed) << module;
+}
+
+void ModulePreloader::onStepFinished(const QString& step)
+{
+    const QString module = step.mid(kStepPrefix.size());
+    bool loaded;
+    {
+        QMutexLocker locker(&m_mutex);
+        loaded = m_loaded.contains(module);
+    }
+    ++m_done;
+    qInfo() << "Preload" << m_done << "/" << m_total << ":" << module << (loaded ? "loaded" : "failed");
+    emit progress(m_done, m_total, module, loaded);
+
+    if (m_done == m_total) {
+        m_running = false;
+        QMutexLocker locker(&m_mutex);
+        const QStringList loadedModules = m_loaded;
+        const QStringList failedModules = m_failed;
+        locker.unlock();
+        emit finished(loadedModules, failedModules);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef MODULEPRELOADER_H
+#define MODULEPRELOADER_H
+
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class CoreHost;
+class StartupScheduler;
+
+// Loads a set of core modules at startup instead of one click at a time.
+//
+// The set comes from a named profile and/or the modules loaded at the end of the
+// last session (both in settings.ini, see interfaces/LogosSettings.h) plus any
+// modules given on the command line. Dependencies named in the modules' metadata
+// are added and loaded first. Loads run on a worker thread, so the GUI thread never
+// waits for a module's host to come up. They run one at a time: every
+// logos_core_load_plugin holds LogosCoreGate until the module is up, so more
+// workers would only wait for each other. Modules that are already loaded are
+// skipped.
+class ModulePreloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ModulePreloader(CoreHost* coreHost, QObject* parent = nullptr);
+    ~ModulePreloader();
+
+    // Reads the settings file; non-empty arguments override it
+    void configure(const QString& profile, const QStringList& modules, bool restoreSession);
+
+    QStringList requestedModules() const { return m_requested; }
+    bool hasModules() const { return !m_requested.isEmpty(); }
+    // [preload] when=firstFrame (default) or when=startup
+    bool startsAfterFirstFrame() const { return m_afterFirstFrame; }
+
+    void start();
+    bool isRunning() const { return m_running; }
+
+    // Remembers the modules for restoreSession
+    static void saveSession(const QStringList& modules);
+
+signals:
+    void progress(int done, int total, const QString& module, bool loaded);
+    void finished(const QStringList& loaded, const QStringList& failed);
+
+private:
+    QStringList loadOrder(const QSet<QString>& alreadyLoaded) const;
+    void visit(const QString& module, const QSet<QString>& alreadyLoaded, QStringList& order,
+               QSet<QString>& visiting, QSet<QString>& visited) const;
+    void loadModule(const QString& module, const QStringList& dependencies);
+    void onStepFinished(const QString& step);
+
+    CoreHost* m_coreHost;
+    StartupScheduler* m_scheduler;
+    QStringList m_requested;
+    bool m_afterFirstFrame;
+    bool m_running;
+    int m_total;
+    int m_done;
+
+    // Written from worker threads
+    mutable QMutex m_mutex;
+    QStringList m_loaded;
+    QStringList m_failed;
+};
+
+#endif // MODULEPRELOADER_H
@@ -0,0 +1,129 @@
+#include "SingleInstance.h"
+#include <QCryptographicHash>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+SingleInstance::SingleInstance(const QString& modulesDir, QObject* parent)
+    : QObject(parent)
+    , m_server(nullptr)
+{
+    m_serverName = serverNameFor("logos-app-", modulesDir);
+}
+
+QString SingleInstance::serverNameFor(const QString& prefix, const QString& modulesDir)
+{
+    // Socket names are global on some platforms, so include the user as well
+    QByteArray key = QDir::cleanPath(modulesDir).toUtf8() + '\0' + qgetenv("USER") + qgetenv("USERNAME");
+    return prefix + QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex().left(16));
+}
+
+namespace {
+
+// Nobody accepts connections on the socket (a crashed instance left it behind, or it never existed)
+bool isAbandoned(QLocalSocket::LocalSocketError error)
+{
+    return error == QLocalSocket::ConnectionRefusedError || error == QLocalSocket::ServerNotFoundError;
+}
+
+}
+
+SingleInstance::ForwardResult SingleInstance::forwardToRunningInstance(const QStringList& arguments,
+                                                                       int connectTimeoutMs,
+                                                                       int ackTimeoutMs)
+{
+    QLocalSocket socket;
+    socket.connectToServer(m_serverName);
+    if (!socket.waitForConnected(connectTimeoutMs)) {
+        if (isAbandoned(socket.error())) {
+            return ForwardResult::NotRunning;
+        }
+        qWarning() << "SingleInstance: running instance did not accept the connection:" << socket.errorString();
+        return ForwardResult::Unresponsive;
+    }
+
+    // Paths are resolved here since the running instance has its own working directory
+    QJsonArray args;
+    for (const QString& argument : arguments) {
+        QFileInfo fileInfo(argument);
+        args.append(fileInfo.exists() ? fileInfo.absoluteFilePath() : argument);
+    }
+    QJsonObject message;
+    message["args"] = args;
+
+    socket.write(QJsonDocument(message).toJson(QJsonDocument::Compact) + '\n');
+    if (!socket.waitForBytesWritten(connectTimeoutMs)) {
+        qWarning() << "SingleInstance: failed to send arguments:" << socket.errorString();
+        return ForwardResult::Unresponsive;
+    }
+
+    // Wait for the acknowledgement so arguments are never silently dropped. The
+    // running instance may still be starting (core start, QML cache rebuild).
+    QDeadlineTimer deadline(ackTimeoutMs);
+    while (!socket.canReadLine()) {
+        if (!socket.waitForReadyRead(int(qMax<qint64>(deadline.remainingTime(), 0)))) {
+            qWarning() << "SingleInstance: running instance did not acknowledge:" << socket.errorString();
+            return ForwardResult::Unresponsive;
+        }
+    }
+    return socket.readLine().trimmed() == "ok" ? ForwardResult::Forwarded : ForwardResult::Unresponsive;
+}
+
+SingleInstance::ListenResult SingleInstance::listen()
+{
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+
+    if (m_server->listen(m_serverName)) {
+        qDebug() << "SingleInstance: listening on" << m_server->fullServerName();
+        return ListenResult::Listening;
+    }
+
+    if (m_server->serverError() == QAbstractSocket::AddressInUseError) {
+        // Only replace the socket if nobody is serving on it anymore
+        QLocalSocket probe;
+        probe.connectToServer(m_serverName);
+        if (probe.waitForConnected(500) || !isAbandoned(probe.error())) {
+            qWarning() << "SingleInstance: another instance is serving" << m_serverName;
+            return ListenResult::AlreadyRunning;
+        }
+        QLocalServer::removeServer(m_serverName);
+        if (m_server->listen(m_serverName)) {
+            qDebug() << "SingleInstance: replaced stale socket" << m_server->fullServerName();
+            return ListenResult::Listening;
+        }
+    }
+
+    qWarning() << "SingleInstance: failed to listen on" << m_serverName << ":" << m_server->errorString();
+    return ListenResult::Failed;
+}
+
+void SingleInstance::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            if (!socket->canReadLine()) {
+                return;
+            }
+            const QJsonDocument doc = QJsonDocument::fromJson(socket->readLine());
+            QStringList arguments;
+            for (const QJsonValue& value : doc.object().value("args").toArray()) {
+                arguments.append(value.toString());
+            }
+            socket->write("ok\n");
+            socket->flush();
+            socket->disconnectFromServer();
+
+            qDebug() << "SingleInstance: received arguments" << arguments;
+            emit argumentsReceived(arguments);
+        });
+    }
+}
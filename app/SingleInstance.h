@@ -0,0 +1,59 @@
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QLocalServer;
+
+// Keeps one running LogosApp per modules directory.
+//
+// The first instance listens on a local socket. A later invocation connects to it,
+// sends its command line arguments (file paths made absolute) and exits, so it
+// never starts a second core on the same modules directory.
+class SingleInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class ForwardResult {
+        Forwarded,     // a running instance accepted the arguments
+        NotRunning,    // nobody is serving the socket
+        Unresponsive   // an instance is serving it but did not acknowledge in time
+    };
+
+    enum class ListenResult {
+        Listening,
+        AlreadyRunning,  // another instance serves the socket; never replaced
+        Failed
+    };
+
+    explicit SingleInstance(const QString& modulesDir, QObject* parent = nullptr);
+
+    // Hands the arguments to a running instance. A starting instance only answers
+    // once its event loop runs, so the acknowledgement gets ackTimeoutMs.
+    ForwardResult forwardToRunningInstance(const QStringList& arguments,
+                                           int connectTimeoutMs = 2000,
+                                           int ackTimeoutMs = 60000);
+
+    // Becomes the instance that receives forwarded arguments. A leftover socket is
+    // only removed when connecting to it is refused or it no longer exists.
+    ListenResult listen();
+
+    QString serverName() const { return m_serverName; }
+
+    // Per-user local socket name for a modules directory, e.g. "logos-app-<hash>"
+    static QString serverNameFor(const QString& prefix, const QString& modulesDir);
+
+signals:
+    void argumentsReceived(const QStringList& arguments);
+
+private:
+    void onNewConnection();
+
+    QString m_serverName;
+    QLocalServer* m_server;
+};
+
+#endif // SINGLEINSTANCE_H
@@ -0,0 +1,210 @@
+#include "StartupProfiler.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QEvent>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSysInfo>
+#include <QThread>
+#include <QTimer>
+#include <QWidget>
+
+namespace {
+
+// Time given to plugins after the window's first frame (QQuickWidget frame swaps etc.)
+const int kReportSettleMs = 1000;
+
+double toMs(qint64 ns)
+{
+    return ns / 1000000.0;
+}
+
+}
+
+StartupProfiler* StartupProfiler::instance()
+{
+    static StartupProfiler* profiler = new StartupProfiler();
+    return profiler;
+}
+
+StartupProfiler::StartupProfiler()
+    : QObject(nullptr)
+    , m_mainThread(QThread::currentThread())
+    , m_reportWritten(false)
+    , m_firstFramePainted(false)
+    , m_watchedWindow(nullptr)
+{
+    m_clock.start();
+}
+
+void StartupProfiler::install()
+{
+    if (qApp) {
+        qApp->setProperty("startupProfiler", QVariant::fromValue<QObject*>(this));
+        connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() {
+            if (!m_reportPath.isEmpty() && !m_reportWritten) {
+                writeReport();
+            }
+        });
+    }
+}
+
+void StartupProfiler::setReportPath(const QString& path)
+{
+    m_reportPath = path;
+}
+
+QString StartupProfiler::currentThreadName() const
+{
+    // Compared with the thread that created the profiler, since phases such as
+    // "qapplication" begin before qApp exists
+    if (QThread::currentThread() == m_mainThread) {
+        return "main";
+    }
+    QString name = QThread::currentThread()->objectName();
+    if (name.isEmpty()) {
+        name = QString("0x%1").arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 16);
+    }
+    return name;
+}
+
+void StartupProfiler::begin(const QString& phase)
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    const QString thread = currentThreadName();
+
+    QMutexLocker locker(&m_mutex);
+    Phase entry;
+    entry.name = phase;
+    entry.thread = thread;
+    entry.startNs = now;
+    // Innermost phase still open on this thread
+    for (int i = m_phases.size() - 1; i >= 0; --i) {
+        if (m_phases[i].endNs < 0 && m_phases[i].thread == thread) {
+            entry.parent = m_phases[i].name;
+            break;
+        }
+    }
+    m_phases.append(entry);
+}
+
+void StartupProfiler::end(const QString& phase)
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    const QString thread = currentThreadName();
+
+    QMutexLocker locker(&m_mutex);
+    for (int i = m_phases.size() - 1; i >= 0; --i) {
+        Phase& entry = m_phases[i];
+        if (entry.endNs < 0 && entry.name == phase && entry.thread == thread) {
+            entry.endNs = now;
+            return;
+        }
+    }
+    qWarning() << "StartupProfiler: end() without begin() for phase" << phase;
+}
+
+void StartupProfiler::mark(const QString& name)
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    const QString thread = currentThreadName();
+
+    QMutexLocker locker(&m_mutex);
+    Mark entry;
+    entry.name = name;
+    entry.thread = thread;
+    entry.atNs = now;
+    m_marks.append(entry);
+}
+
+void StartupProfiler::watchFirstFrame(QWidget* window)
+{
+    if (!window || m_watchedWindow) {
+        return;
+    }
+    m_watchedWindow = window;
+    window->installEventFilter(this);
+}
+
+bool StartupProfiler::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_watchedWindow && event->type() == QEvent::Paint) {
+        m_watchedWindow->removeEventFilter(this);
+        // The backing store is flushed once the paint event has been handled
+        QTimer::singleShot(0, this, [this]() {
+            mark("window.firstFrame");
+            m_firstFramePainted = true;
+            qInfo() << "Startup: first frame after" << toMs(m_clock.nsecsElapsed()) << "ms";
+            emit firstFrame();
+            if (!m_reportPath.isEmpty()) {
+                QTimer::singleShot(kReportSettleMs, this, [this]() { writeReport(); });
+            }
+        });
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+bool StartupProfiler::writeReport()
+{
+    if (m_reportPath.isEmpty()) {
+        return false;
+    }
+
+    QJsonObject report;
+    report["version"] = 1;
+    report["generatedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["application"] = QCoreApplication::applicationName();
+    report["platform"] = QSysInfo::prettyProductName() + " " + QSysInfo::currentCpuArchitecture();
+    report["clock"] = "monotonic, milliseconds since the start of main()";
+
+    {
+        QMutexLocker locker(&m_mutex);
+        QJsonArray phases;
+        for (const Phase& entry : m_phases) {
+            QJsonObject phase;
+            phase["name"] = entry.name;
+            if (!entry.parent.isEmpty()) {
+                phase["parent"] = entry.parent;
+            }
+            phase["thread"] = entry.thread;
+            phase["startMs"] = toMs(entry.startNs);
+            if (entry.endNs >= 0) {
+                phase["endMs"] = toMs(entry.endNs);
+                phase["durationMs"] = toMs(entry.endNs - entry.startNs);
+            } else {
+                phase["endMs"] = QJsonValue::Null;
+                phase["durationMs"] = QJsonValue::Null;
+            }
+            phases.append(phase);
+        }
+        report["phases"] = phases;
+
+        QJsonArray marks;
+        for (const Mark& entry : m_marks) {
+            QJsonObject mark;
+            mark["name"] = entry.name;
+            mark["thread"] = entry.thread;
+            mark["atMs"] = toMs(entry.atNs);
+            marks.append(mark);
+        }
+        report["marks"] = marks;
+    }
+    report["reportMs"] = toMs(m_clock.nsecsElapsed());
+
+    QDir().mkpath(QFileInfo(m_reportPath).absolutePath());
+    QFile file(m_reportPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write startup report to" << m_reportPath << ":" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+    m_reportWritten = true;
+    qInfo() << "Startup report written to" << QFileInfo(m_reportPath).absoluteFilePath();
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+class QThread;
+class QWidget;
+
+// Records monotonic timestamps for the phases of application startup.
+//
+// Phases are recorded with begin()/end() (nesting is tracked per thread) and
+// single points in time with mark(). Plugins reach the profiler through the
+// "startupProfiler" property on qApp (see interfaces/StartupTrace.h), so they do
+// not need to link against the app. When a report path is set, a JSON report is
+// written shortly after the main window has drawn its first frame.
+class StartupProfiler : public QObject
+{
+    Q_OBJECT
+    // Read by plugins through qApp, like the methods below
+    Q_PROPERTY(bool firstFramePainted READ hasFirstFrame NOTIFY firstFrame)
+
+public:
+    // First called from the main thread, which is recorded as "main"
+    static StartupProfiler* instance();
+
+    // Exposes the profiler as qApp->property("startupProfiler")
+    void install();
+
+    void setReportPath(const QString& path);
+    QString reportPath() const { return m_reportPath; }
+
+    // Marks "window.firstFrame" once the window has painted, then writes the report
+    void watchFirstFrame(QWidget* window);
+    bool hasFirstFrame() const { return m_firstFramePainted; }
+
+    Q_INVOKABLE void begin(const QString& phase);
+    Q_INVOKABLE void end(const QString& phase);
+    Q_INVOKABLE void mark(const QString& name);
+
+    bool writeReport();
+
+signals:
+    void firstFrame();
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    StartupProfiler();
+
+    struct Phase {
+        QString name;
+        QString parent;
+        QString thread;
+        qint64 startNs = 0;
+        qint64 endNs = -1;
+    };
+
+    struct Mark {
+        QString name;
+        QString thread;
+        qint64 atNs = 0;
+    };
+
+    QString currentThreadName() const;
+
+    QElapsedTimer m_clock;
+    QThread* m_mainThread;
+    mutable QMutex m_mutex;
+    QList<Phase> m_phases;
+    QList<Mark> m_marks;
+    QString m_reportPath;
+    bool m_reportWritten;
+    bool m_firstFramePainted;
+    QWidget* m_watchedWindow;
+};
+
+#endif // STARTUPPROFILER_H
@@ -0,0 +1,171 @@
+#include "StartupScheduler.h"
+#include "StartupProfiler.h"
+#include <QDebug>
+#include <QEventLoop>
+#include <QThread>
+
+StartupScheduler::StartupScheduler(QObject* parent)
+    : QObject(parent)
+    , m_parallel(true)
+    , m_started(false)
+    , m_remaining(0)
+{
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+}
+
+StartupScheduler::~StartupScheduler()
+{
+    // Worker steps capture state owned by main(); never let them outlive it
+    m_pool.waitForDone();
+}
+
+void StartupScheduler::setParallel(bool parallel)
+{
+    m_parallel = parallel;
+}
+
+void StartupScheduler::setMaxThreadCount(int count)
+{
+    m_pool.setMaxThreadCount(qMax(1, count));
+}
+
+bool StartupScheduler::addStep(const QString& name, Affinity affinity, std::function<void()> work,
+                               const QStringList& dependsOn)
+{
+    if (m_started) {
+        qWarning() << "StartupScheduler: cannot add step" << name << "after start()";
+        return false;
+    }
+    if (m_steps.contains(name)) {
+        qWarning() << "StartupScheduler: duplicate step" << name;
+        return false;
+    }
+    for (const QString& dependency : dependsOn) {
+        if (!m_steps.contains(dependency)) {
+            qWarning() << "StartupScheduler: step" << name << "depends on unknown step" << dependency;
+            return false;
+        }
+    }
+
+    Step step;
+    step.affinity = affinity;
+    step.work = std::move(work);
+    step.dependsOn = dependsOn;
+    m_steps.insert(name, step);
+    m_order.append(name);
+    ++m_remaining;
+    return true;
+}
+
+bool StartupScheduler::addExternalStep(const QString& name)
+{
+    if (!addStep(name, Affinity::Main, nullptr)) {
+        return false;
+    }
+    m_steps[name].external = true;
+    return true;
+}
+
+void StartupScheduler::completeExternalStep(const QString& name)
+{
+    auto it = m_steps.find(name);
+    if (it == m_steps.end() || !it->external || it->state == State::Done) {
+        return;
+    }
+    onStepFinished(name);
+}
+
+void StartupScheduler::start()
+{
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+    dispatchReady();
+}
+
+void StartupScheduler::dispatchReady()
+{
+    for (const QString& name : m_order) {
+        Step& step = m_steps[name];
+        if (step.state != State::Pending || step.external) {
+            continue;
+        }
+        bool ready = true;
+        for (const QString& dependency : step.dependsOn) {
+            if (m_steps.value(dependency).state != State::Done) {
+                ready = false;
+                break;
+            }
+        }
+        if (!ready) {
+            continue;
+        }
+
+        step.state = State::Running;
+        std::function<void()> work = step.work;
+        if (step.affinity == Affinity::Worker && m_parallel) {
+            m_pool.start([this, name, work]() {
+                QThread::currentThread()->setObjectName("startup:" + name);
+                runStep(name, work);
+                QMetaObject::invokeMethod(this, [this, name]() { onStepFinished(name); }, Qt::QueuedConnection);
+            });
+        } else {
+            QMetaObject::invokeMethod(this, [this, name, work]() {
+                runStep(name, work);
+                onStepFinished(name);
+            }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void StartupScheduler::runStep(const QString& name, const std::function<void()>& work)
+{
+    StartupProfiler::instance()->begin(name);
+    if (work) {
+        work();
+    }
+    StartupProfiler::instance()->end(name);
+}
+
+void StartupScheduler::onStepFinished(const QString& name)
+{
+    m_steps[name].state = State::Done;
+    --m_remaining;
+    emit stepFinished(name);
+
+    dispatchReady();
+    if (m_remaining == 0) {
+        emit finished();
+    }
+}
+
+void StartupScheduler::runUntil(const QString& name)
+{
+    if (!m_steps.contains(name)) {
+        qWarning() << "StartupScheduler: runUntil() for unknown step" << name;
+        return;
+    }
+    start();
+    if (isFinished(name)) {
+        return;
+    }
+
+    QEventLoop loop;
+    connect(this, &StartupScheduler::stepFinished, &loop, [&loop, name](const QString& finished) {
+        if (finished == name) {
+            loop.quit();
+        }
+    });
+    loop.exec();
+}
+
+bool StartupScheduler::isFinished(const QString& name) const
+{
+    return m_steps.value(name).state == State::Done;
+}
+
+bool StartupScheduler::isFinished() const
+{
+    return m_started && m_remaining == 0;
+}
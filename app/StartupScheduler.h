@@ -0,0 +1,84 @@
+#ifndef STARTUPSCHEDULER_H
+#define STARTUPSCHEDULER_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <functional>
+
+// Runs startup steps as soon as their dependencies are done.
+//
+// Each step declares the steps it depends on (which must have been added before
+// it, so the graph cannot have cycles) and whether it has to run on the main
+// thread or may run on a worker thread. Main thread steps are run from the event
+// loop, so runUntil() can be used before QApplication::exec() to drive startup up
+// to a given step while the remaining steps continue once the loop is running.
+// Every step is recorded as a phase in the StartupProfiler.
+class StartupScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Affinity {
+        Main,    // Qt widgets, logos_core_* setup and anything else that is not thread safe
+        Worker   // Self-contained work such as pre-loading plugin libraries
+    };
+
+    explicit StartupScheduler(QObject* parent = nullptr);
+    ~StartupScheduler();
+
+    // Runs worker steps on the main thread as well, in dependency order
+    void setParallel(bool parallel);
+    // Worker steps running at the same time (default: ideal thread count, at least 2)
+    void setMaxThreadCount(int count);
+
+    bool addStep(const QString& name, Affinity affinity, std::function<void()> work,
+                 const QStringList& dependsOn = QStringList());
+
+    // A step that is finished from outside, e.g. when the first frame has been drawn
+    bool addExternalStep(const QString& name);
+    void completeExternalStep(const QString& name);
+
+    // Starts every step whose dependencies are met; returns immediately
+    void start();
+
+    // Processes events until the step has finished
+    void runUntil(const QString& name);
+
+    bool isFinished(const QString& name) const;
+    bool isFinished() const;
+
+signals:
+    void stepFinished(const QString& name);
+    void finished();
+
+private:
+    enum class State {
+        Pending,
+        Running,
+        Done
+    };
+
+    struct Step {
+        Affinity affinity = Affinity::Main;
+        std::function<void()> work;
+        QStringList dependsOn;
+        bool external = false;
+        State state = State::Pending;
+    };
+
+    void dispatchReady();
+    void onStepFinished(const QString& name);
+    static void runStep(const QString& name, const std::function<void()>& work);
+
+    QHash<QString, Step> m_steps;
+    QStringList m_order;
+    QThreadPool m_pool;
+    bool m_parallel;
+    bool m_started;
+    int m_remaining;
+};
+
+#endif // STARTUPSCHEDULER_H
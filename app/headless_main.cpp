@@ -0,0 +1,130 @@
+// Headless core host: runs logos_core and its modules without QtWidgets/QtQuick,
+// for machines without a display. Status and module stats are served on a local
+// socket and can also be written to a file.
+#include "CoreHost.h"
+#include "HeadlessStatusServer.h"
+#include "SingleInstance.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QStringList>
+#include <iostream>
+
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+#include <csignal>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+int signalFds[2] = {-1, -1};
+
+void onTerminationSignal(int)
+{
+    char signalByte = 1;
+    // Only async-signal-safe calls here. A failed write means the socket is full,
+    // so a wake-up is already pending
+    if (::write(signalFds[0], &signalByte, sizeof(signalByte)) < 0) {
+        return;
+    }
+}
+
+// SIGINT/SIGTERM quit the event loop so the core gets to stop its module processes
+void quitOnTerminationSignals(QCoreApplication* app)
+{
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalFds) != 0) {
+        qWarning() << "Failed to set up signal handling; modules may outlive the host";
+        return;
+    }
+    QSocketNotifier* notifier = new QSocketNotifier(signalFds[1], QSocketNotifier::Read, app);
+    QObject::connect(notifier, &QSocketNotifier::activated, app, [notifier]() {
+        char signalByte;
+        if (::read(signalFds[1], &signalByte, sizeof(signalByte)) != sizeof(signalByte)) {
+            return;  // Spurious wake-up; keep listening
+        }
+        notifier->setEnabled(false);
+        qInfo() << "Termination signal received, shutting down";
+        QCoreApplication::quit();
+    });
+    std::signal(SIGINT, onTerminationSignal);
+    std::signal(SIGTERM, onTerminationSignal);
+}
+
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("LogosApp");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs the Logos core and its modules without a UI.");
+    parser.addHelpOption();
+    QCommandLineOption modulesDirOption("modules-dir",
+        "Modules directory (default: ../modules next to the executable).", "dir");
+    parser.addOption(modulesDirOption);
+    QCommandLineOption preloadOption("preload",
+        "Comma-separated modules to load after package_manager.", "modules");
+    parser.addOption(preloadOption);
+    QCommandLineOption statsIntervalOption("stats-interval",
+        "Module stats sampling interval in milliseconds (default: 2000).", "ms", "2000");
+    parser.addOption(statsIntervalOption);
+    QCommandLineOption statsFileOption("stats-file",
+        "Rewrite <file> with the host status and module stats after every sample.", "file");
+    parser.addOption(statsFileOption);
+    QCommandLineOption statusSocketOption("status-socket",
+        "Local socket name for status queries (default: derived from the modules directory).", "name");
+    parser.addOption(statusSocketOption);
+    QCommandLineOption quietOption("quiet", "Don't print module stats to stdout.");
+    parser.addOption(quietOption);
+    parser.process(app);
+
+    CoreHost coreHost(parser.isSet(modulesDirOption) ? parser.value(modulesDirOption)
+                                                     : CoreHost::defaultModulesDirectory());
+
+    HeadlessStatusServer statusServer(&coreHost);
+    const QString socketName = parser.isSet(statusSocketOption)
+        ? parser.value(statusSocketOption)
+        : SingleInstance::serverNameFor("logos-headless-", coreHost.modulesDirectory());
+    if (!statusServer.listen(socketName)) {
+        return 1;
+    }
+    statusServer.setStatsFile(parser.value(statsFileOption));
+
+#ifdef Q_OS_UNIX
+    quitOnTerminationSignals(&app);
+#endif
+
+    coreHost.configure();
+    coreHost.start();
+    std::cout << "Logos Core started successfully (headless)!" << std::endl;
+
+    QStringList modules{"package_manager"};
+    for (const QString& name : parser.value(preloadOption).split(',', Qt::SkipEmptyParts)) {
+        if (!modules.contains(name.trimmed())) {
+            modules << name.trimmed();
+        }
+    }
+    statusServer.setFailedModules(coreHost.loadModules(modules));
+    coreHost.logLoadedModules();
+
+    if (!parser.isSet(quietOption)) {
+        QObject::connect(&coreHost, &CoreHost::statsSampled, [](const QByteArray& statsJson) {
+            std::cout << "Module stats: " << statsJson.constData() << std::endl;
+        });
+    }
+    bool ok = false;
+    int statsInterval = parser.value(statsIntervalOption).toInt(&ok);
+    if (!ok || statsInterval < 100) {
+        statsInterval = 2000;
+    }
+    coreHost.startStatsSampling(statsInterval);
+    coreHost.sampleStats();
+
+    int result = app.exec();
+
+    coreHost.cleanup();
+    return result;
+}
@@ -0,0 +1,39 @@
+#ifndef LOGOSCOREGATE_H
+#define LOGOSCOREGATE_H
+
+#include <QCoreApplication>
+#include <QMutex>
+#include <QVariant>
+
+// One lock for every logos_core_* call in the process. liblogos keeps process-wide
+// state and is not known to be reentrant, but the app and the UI plugins are
+// separate binaries, so a static mutex in each would not exclude the other. The
+// host publishes its mutex through qApp and every binary locks that one.
+//
+// A logos_core_load_plugin call holds the gate until the module's host is up, so
+// code on the GUI thread should use tryLock() and try again later instead of
+// waiting for it.
+namespace LogosCoreGate {
+
+inline QMutex& mutex()
+{
+    static QMutex own;  // Used until the host has published its own
+    if (qApp) {
+        if (void* published = qApp->property("logosCoreMutex").value<void*>()) {
+            return *static_cast<QMutex*>(published);
+        }
+    }
+    return own;
+}
+
+// Called once by the host on the main thread, before any plugin is loaded
+inline void publish()
+{
+    if (qApp) {
+        qApp->setProperty("logosCoreMutex", QVariant::fromValue(static_cast<void*>(&mutex())));
+    }
+}
+
+}
+
+#endif // LOGOSCOREGATE_H
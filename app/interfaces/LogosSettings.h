@@ -0,0 +1,36 @@
+#ifndef LOGOSSETTINGS_H
+#define LOGOSSETTINGS_H
+
+#include <QSettings>
+#include <QStandardPaths>
+#include <QString>
+#include <memory>
+
+// The app's user settings file, <AppConfigLocation>/settings.ini. Header-only so
+// plugins read and write the same file as the app without linking against it.
+//
+//   [preload]
+//   profile=operator          ; profile loaded when none is given on the command line
+//   restoreSession=false      ; also load the modules that were loaded at last exit
+//   when=firstFrame           ; or "startup"
+//
+//   [profiles]
+//   operator=chat, wallet, storage
+//
+//   [session]
+//   modules=...               ; written by the app at exit
+namespace LogosSettings {
+
+inline QString path()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/settings.ini";
+}
+
+inline std::unique_ptr<QSettings> open()
+{
+    return std::make_unique<QSettings>(path(), QSettings::IniFormat);
+}
+
+} // namespace LogosSettings
+
+#endif // LOGOSSETTINGS_H
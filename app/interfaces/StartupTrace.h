@@ -0,0 +1,54 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QString>
+#include <QVariant>
+
+// Records startup phases in the host application's startup profiler, if it has one.
+// The profiler is looked up through qApp so plugins need no link-time dependency.
+namespace StartupTrace {
+
+inline QObject* profiler()
+{
+    return qApp ? qApp->property("startupProfiler").value<QObject*>() : nullptr;
+}
+
+inline void begin(const QString& phase)
+{
+    if (QObject* p = profiler()) {
+        QMetaObject::invokeMethod(p, "begin", Qt::DirectConnection, Q_ARG(QString, phase));
+    }
+}
+
+inline void end(const QString& phase)
+{
+    if (QObject* p = profiler()) {
+        QMetaObject::invokeMethod(p, "end", Qt::DirectConnection, Q_ARG(QString, phase));
+    }
+}
+
+inline void mark(const QString& name)
+{
+    if (QObject* p = profiler()) {
+        QMetaObject::invokeMethod(p, "mark", Qt::DirectConnection, Q_ARG(QString, name));
+    }
+}
+
+// Begins a phase and ends it when the scope is left
+class Scope
+{
+public:
+    explicit Scope(const QString& phase) : m_phase(phase) { begin(m_phase); }
+    ~Scope() { end(m_phase); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    QString m_phase;
+};
+
+}
+
+#endif // STARTUPTRACE_H
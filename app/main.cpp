@@ -1,8 +1,14 @@
 #include "window.h"
+#include "StartupProfiler.h"
+#include "StartupScheduler.h"
+#include "SingleInstance.h"
+#include "CoreHost.h"
+#include "ModulePreloader.h"
 #include "logos_api.h"
 #include "token_manager.h"
 #include "logos_mode.h"
 #include <QApplication>
+#include <QSystemTrayIcon>
 #include <QIcon>
 #include <QDir>
 #include <QTimer>
@@ -12,90 +18,100 @@
 #include <QStringList>
 #include <QDebug>
 #include <QMetaObject>
-
-// Replace CoreManager with direct C API functions
-extern "C" {
-    void logos_core_set_plugins_dir(const char* plugins_dir);
-    void logos_core_add_plugins_dir(const char* plugins_dir);
-    void logos_core_start();
-    void logos_core_cleanup();
-    char** logos_core_get_loaded_plugins();
-    int logos_core_load_plugin(const char* plugin_name);
-    char* logos_core_process_plugin(const char* plugin_path);
-    char* logos_core_get_module_stats();
-}
-
-// Helper function to convert C-style array to QStringList
-QStringList convertPluginsToStringList(char** plugins) {
-    QStringList result;
-    if (plugins) {
-        for (int i = 0; plugins[i] != nullptr; i++) {
-            result.append(plugins[i]);
-        }
-    }
-    return result;
-}
+#include <QCommandLineParser>
+#include <QPluginLoader>
 
 int main(int argc, char *argv[])
 {
     // Set logos mode to Local for testing
     //LogosModeConfig::setMode(LogosMode::Local);
 
-    // Create QApplication first
-    QApplication app(argc, argv);
+    // Start the startup clock before anything else
+    StartupProfiler* profiler = StartupProfiler::instance();
 
-    QString modulesDir = QDir::cleanPath(QCoreApplication::applicationDirPath() + "/../modules");
-    logos_core_set_plugins_dir(modulesDir.toUtf8().constData());
+    // Names the data and config directories, so they must be set before anything
+    // looks one up
+    QCoreApplication::setOrganizationName("Logos");
+    QCoreApplication::setApplicationName("LogosApp");
 
-    QFileInfo bundledDirInfo(modulesDir);
-    if (!bundledDirInfo.isWritable()) {
-        QString userModulesDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/modules";
-        logos_core_add_plugins_dir(userModulesDir.toUtf8().constData());
+    // Plugins' QML is precompiled into this directory (see src/QmlPluginCache.h).
+    // Qt reads the variable when it loads QML; it is set here, before any thread
+    // exists, because changing the environment races with other threads reading it.
+    if (!qEnvironmentVariableIsSet("QML_DISK_CACHE_PATH")) {
+        const QString qmlCacheDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/qmlcache/";
+        QDir().mkpath(qmlCacheDir);
+        qputenv("QML_DISK_CACHE_PATH", qmlCacheDir.toUtf8());
     }
 
-    // Start the core
-    logos_core_start();
-    std::cout << "Logos Core started successfully!" << std::endl;
-
-    // TODO: this should be refactored
-    QString pluginExtension;
-#if defined(Q_OS_MAC)
-    pluginExtension = ".dylib";
-#elif defined(Q_OS_WIN)
-    pluginExtension = ".dll";
-#else // Linux and others
-    pluginExtension = ".so";
-#endif
-
-    QString pluginPath = modulesDir + "/package_manager_plugin" + pluginExtension;
-    logos_core_process_plugin(pluginPath.toUtf8().constData());
-    bool loaded = logos_core_load_plugin("package_manager");
-
-    if (loaded) {
-        qInfo() << "package_manager plugin loaded by default.";
-    } else {
-        qWarning() << "Failed to load package_manager plugin by default.";
+    // Create QApplication first
+    profiler->begin("qapplication");
+    QApplication app(argc, argv);
+    profiler->end("qapplication");
+    profiler->install();
+
+    // Only options known here are parsed; unknown arguments are left alone
+    QCommandLineParser parser;
+    QCommandLineOption startupReportOption("startup-report",
+        "Write a JSON report of startup phase timings to <file>.", "file");
+    parser.addOption(startupReportOption);
+    QCommandLineOption sequentialStartupOption("sequential-startup",
+        "Run all startup steps one after another on the main thread.");
+    parser.addOption(sequentialStartupOption);
+    QCommandLineOption deferPackageManagerOption("defer-package-manager",
+        "Show the main window first and load the package manager after its first frame.");
+    parser.addOption(deferPackageManagerOption);
+    QCommandLineOption multiInstanceOption("multi-instance",
+        "Start a separate instance even if one is already running for the same modules directory.");
+    parser.addOption(multiInstanceOption);
+    QCommandLineOption backgroundOption("background",
+        "Start with only the tray icon; the main UI is loaded when the window is first shown.");
+    parser.addOption(backgroundOption);
+    QCommandLineOption preloadProfileOption("preload-profile",
+        "Load the core modules of the named profile from settings.ini.", "name");
+    parser.addOption(preloadProfileOption);
+    QCommandLineOption preloadOption("preload",
+        "Comma-separated core modules to load at startup.", "modules");
+    parser.addOption(preloadOption);
+    QCommandLineOption restoreSessionOption("restore-session",
+        "Load the core modules that were loaded when the app last exited.");
+    parser.addOption(restoreSessionOption);
+    parser.parse(app.arguments());
+    if (parser.isSet(startupReportOption)) {
+        profiler->setReportPath(parser.value(startupReportOption));
     }
 
-    // Print loaded plugins initially
-    char** loadedPlugins = logos_core_get_loaded_plugins();
-    QStringList plugins = convertPluginsToStringList(loadedPlugins);
+    CoreHost coreHost(CoreHost::defaultModulesDirectory());
+    const QString modulesDir = coreHost.modulesDirectory();
 
-    if (plugins.isEmpty()) {
-        qInfo() << "No plugins loaded.";
-    } else {
-        qInfo() << "Currently loaded plugins:";
-        foreach (const QString &plugin, plugins) {
-            qInfo() << "  -" << plugin;
+    // A second launch hands its arguments (.lgx/plugin files to install, app names
+    // to open) to the running instance instead of starting another core
+    std::unique_ptr<SingleInstance> singleInstance;
+    QList<QStringList> pendingForwardedArguments;
+    if (!parser.isSet(multiInstanceOption)) {
+        singleInstance = std::make_unique<SingleInstance>(modulesDir);
+        switch (singleInstance->forwardToRunningInstance(parser.positionalArguments())) {
+        case SingleInstance::ForwardResult::Forwarded:
+            qInfo() << "Logos App is already running; arguments forwarded to it.";
+            return 0;
+        case SingleInstance::ForwardResult::Unresponsive:
+            // Never start a second core next to an instance that is still alive
+            qCritical() << "Logos App is already running but did not respond; try again once it has started.";
+            return 1;
+        case SingleInstance::ForwardResult::NotRunning:
+            break;
+        }
+        if (singleInstance->listen() == SingleInstance::ListenResult::AlreadyRunning) {
+            // Another launch won the race for the socket
+            qCritical() << "Logos App is already running.";
+            return 1;
         }
-        qInfo() << "Total plugins:" << plugins.size();
+        QObject::connect(singleInstance.get(), &SingleInstance::argumentsReceived, singleInstance.get(),
+                         [&pendingForwardedArguments](const QStringList& arguments) {
+            pendingForwardedArguments.append(arguments);
+        });
     }
-
-    LogosAPI logosAPI("core", nullptr);
-    qDebug() << "LogosAPI: printing keys";
-    QList<QString> keys = logosAPI.getTokenManager()->getTokenKeys();
-    for (const QString& key : keys) {
-        qDebug() << "LogosAPI: Token key:" << key << "value:" << logosAPI.getTokenManager()->getToken(key);
+    if (!parser.positionalArguments().isEmpty()) {
+        pendingForwardedArguments.append(parser.positionalArguments());
     }
 
     // Set application icon
@@ -104,26 +120,178 @@ int main(int argc, char *argv[])
     // Don't quit when last window is closed (for system tray support)
     app.setQuitOnLastWindowClosed(false);
 
+    // Startup runs as a dependency graph. The core and everything touching widgets
+    // stay on the main thread; the UI plugin libraries are loaded (dlopen,
+    // relocations, static initialisers) on worker threads while the core starts,
+    // so Window::setupUi() finds them already resident.
+    std::unique_ptr<LogosAPI> logosAPI;
+    std::unique_ptr<Window> mainWindow;
+    QList<QPluginLoader*> preloadedPlugins;
+
+    StartupScheduler scheduler;
+    scheduler.setParallel(!parser.isSet(sequentialStartupOption));
+    const bool deferPackageManager = parser.isSet(deferPackageManagerOption);
+    const bool startInBackground = parser.isSet(backgroundOption);
+
+    ModulePreloader preloader(&coreHost);
+    preloader.configure(parser.value(preloadProfileOption),
+                        parser.value(preloadOption).split(',', Qt::SkipEmptyParts),
+                        parser.isSet(restoreSessionOption));
+    // Nothing is painted in the background, so the preload starts right away there
+    const bool preloadAfterFirstFrame = preloader.hasModules() && preloader.startsAfterFirstFrame()
+                                        && !startInBackground;
+    if (startInBackground && !QSystemTrayIcon::isSystemTrayAvailable()) {
+        qWarning() << "--background: no system tray available; launch the app again to show the window";
+    }
+
+    scheduler.addStep("core.configure", StartupScheduler::Affinity::Main, [&]() {
+        coreHost.configure();
+    });
+
+    for (const QString& uiPlugin : {QStringLiteral("package_manager_ui"), QStringLiteral("main_ui")}) {
+        if (Window::hasStaticUiPlugin(uiPlugin) || startInBackground) {
+            // Linked into the executable, or not needed until the window is first shown
+            scheduler.addStep(uiPlugin + ".preload", StartupScheduler::Affinity::Main, nullptr);
+            continue;
+        }
+        QPluginLoader* loader = new QPluginLoader(Window::uiPluginPath(uiPlugin));
+        preloadedPlugins.append(loader);
+        scheduler.addStep(uiPlugin + ".preload", StartupScheduler::Affinity::Worker, [loader]() {
+            // Only the library is loaded here; the plugin instance is created on the main thread
+            if (!loader->load()) {
+                qWarning() << "Failed to preload UI plugin:" << loader->errorString();
+            }
+        });
+    }
+
+    scheduler.addStep("core.start", StartupScheduler::Affinity::Main, [&]() {
+        coreHost.start();
+        std::cout << "Logos Core started successfully!" << std::endl;
+    }, {"core.configure"});
+
+    scheduler.addStep("logos_api", StartupScheduler::Affinity::Main, [&]() {
+        logosAPI = std::make_unique<LogosAPI>("core", nullptr);
+        qDebug() << "LogosAPI: printing keys";
+        QList<QString> keys = logosAPI->getTokenManager()->getTokenKeys();
+        for (const QString& key : keys) {
+            qDebug() << "LogosAPI: Token key:" << key << "value:" << logosAPI->getTokenManager()->getToken(key);
+        }
+    }, {"core.start"});
+
     // Create and show the main window
-    Window mainWindow(&logosAPI);
-    mainWindow.show();
-
-    // Set up timer to poll module stats every 2 seconds
-    QTimer* statsTimer = new QTimer(&app);
-    QObject::connect(statsTimer, &QTimer::timeout, [&]() {
-        char* stats_json = logos_core_get_module_stats();
-        if (stats_json) {
-            std::cout << "Module stats: " << stats_json << std::endl;
-            delete[] stats_json;
+    QStringList windowDependencies{"logos_api", "main_ui.preload"};
+    QStringList packageManagerDependencies{"core.start"};
+    if (deferPackageManager || preloadAfterFirstFrame) {
+        scheduler.addExternalStep("window.painted");
+        QObject::connect(profiler, &StartupProfiler::firstFrame, &scheduler, [&scheduler]() {
+            scheduler.completeExternalStep("window.painted");
+        });
+    }
+    if (deferPackageManager) {
+        // The package manager comes up after the first frame; main_ui shows a
+        // placeholder until its widget is attached
+        packageManagerDependencies << "window.painted";
+    } else {
+        windowDependencies << "core.package_manager" << "package_manager_ui.preload";
+    }
+
+    scheduler.addStep("core.package_manager", StartupScheduler::Affinity::Main, [&]() {
+        if (coreHost.loadModule("package_manager")) {
+            qInfo() << "package_manager plugin loaded by default.";
+        } else {
+            qWarning() << "Failed to load package_manager plugin by default.";
+        }
+
+        // Print loaded plugins initially
+        coreHost.logLoadedModules();
+    }, packageManagerDependencies);
+
+    scheduler.addStep("window.create", StartupScheduler::Affinity::Main, [&]() {
+        mainWindow = std::make_unique<Window>(logosAPI.get(), deferPackageManager, startInBackground);
+    }, windowDependencies);
+
+    scheduler.addStep("window.show", StartupScheduler::Affinity::Main, [&]() {
+        profiler->watchFirstFrame(mainWindow.get());
+        if (!startInBackground) {
+            mainWindow->show();
+            return;
+        }
+        // Nothing is painted until someone opens the window, so don't hold the
+        // deferred package manager back for it
+        profiler->mark("window.background");
+        scheduler.completeExternalStep("window.painted");
+        if (!profiler->reportPath().isEmpty()) {
+            QTimer::singleShot(1000, profiler, [profiler]() { profiler->writeReport(); });
+        }
+    }, {"window.create"});
+
+    if (deferPackageManager) {
+        scheduler.addStep("package_manager_ui.attach", StartupScheduler::Affinity::Main, [&]() {
+            mainWindow->attachPackageManagerUi();
+        }, {"window.show", "core.package_manager", "package_manager_ui.preload"});
+    }
+
+    if (preloader.hasModules()) {
+        QStringList preloadDependencies{"core.package_manager"};
+        if (preloadAfterFirstFrame) {
+            preloadDependencies << "window.painted";
+        }
+        QObject::connect(&preloader, &ModulePreloader::progress, &app,
+                         [&mainWindow](int done, int total, const QString& module) {
+            if (mainWindow) {
+                mainWindow->setStatusMessage(QString("Loading modules %1/%2 (%3)").arg(done).arg(total).arg(module));
+            }
+        });
+        QObject::connect(&preloader, &ModulePreloader::finished, &app,
+                         [&mainWindow](const QStringList& loaded, const QStringList& failed) {
+            qInfo() << "Module preload finished:" << loaded.size() << "loaded," << failed.size() << "failed" << failed;
+            if (mainWindow) {
+                mainWindow->setStatusMessage(failed.isEmpty() ? QString()
+                    : QString("Failed to load: %1").arg(failed.join(", ")));
+            }
+        });
+        scheduler.addStep("modules.preload", StartupScheduler::Affinity::Main, [&]() {
+            preloader.start();
+        }, preloadDependencies);
+    }
+
+    scheduler.runUntil("window.show");
+
+    if (singleInstance) {
+        QObject::disconnect(singleInstance.get(), &SingleInstance::argumentsReceived, singleInstance.get(), nullptr);
+        QObject::connect(singleInstance.get(), &SingleInstance::argumentsReceived, mainWindow.get(),
+                         &Window::handleForwardedArguments);
+    }
+    // Our own arguments and launches that arrived while starting up
+    for (const QStringList& arguments : pendingForwardedArguments) {
+        mainWindow->handleForwardedArguments(arguments);
+    }
+
+    // Poll module stats every 2 seconds
+    QObject::connect(&coreHost, &CoreHost::statsSampled, [](const QByteArray& statsJson) {
+        std::cout << "Module stats: " << statsJson.constData() << std::endl;
+    });
+    coreHost.startStatsSampling(mainWindow->isInBackground() ? 30000 : 2000);
+
+    // Sample rarely while the window is hidden; resume with a fresh sample
+    QObject::connect(mainWindow.get(), &Window::backgroundModeChanged, &coreHost, [&coreHost](bool inBackground) {
+        coreHost.startStatsSampling(inBackground ? 30000 : 2000);
+        if (!inBackground) {
+            coreHost.sampleStats();
         }
     });
-    statsTimer->start(2000);
 
     // Run the application
     int result = app.exec();
 
+    // Remembered for --restore-session
+    ModulePreloader::saveSession(CoreHost::loadedModules());
+
     // Cleanup
-    logos_core_cleanup();
+    mainWindow.reset();
+    logosAPI.reset();
+    qDeleteAll(preloadedPlugins);
+    coreHost.cleanup();
 
     return result;
 } 
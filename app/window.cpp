@@ -1,4 +1,5 @@
 #include "window.h"
+#include "StartupProfiler.h"
 #include <QApplication>
 #include <QScreen>
 #include <QDebug>
@@ -6,10 +7,13 @@
 #include <QVBoxLayout>
 #include <QPluginLoader>
 #include <QDir>
+#include <QFileInfo>
 #include <QSystemTrayIcon>
 #include <QMenu>
 #include <QAction>
 #include <QCloseEvent>
+#include <QHideEvent>
+#include <QShowEvent>
 #include <QIcon>
 #include <QPixmap>
 #include <IComponent.h>
@@ -22,24 +26,38 @@
 Window::Window(QWidget *parent)
     : QMainWindow(parent)
     , m_logosAPI(nullptr)
+    , m_deferPackageManager(false)
+    , m_uiBuilt(false)
+    , m_packageManagerAttachPending(false)
+    , m_mainUiPlugin(nullptr)
+    , m_inBackground(false)
     , m_trayIcon(nullptr)
     , m_trayIconMenu(nullptr)
     , m_showHideAction(nullptr)
     , m_quitAction(nullptr)
 {
     setupUi();
+    ensureUi();
     createTrayIcon();
 }
 
-Window::Window(LogosAPI* logosAPI, QWidget *parent)
+Window::Window(LogosAPI* logosAPI, bool deferPackageManager, bool buildUiOnShow, QWidget *parent)
     : QMainWindow(parent)
     , m_logosAPI(logosAPI)
+    , m_deferPackageManager(deferPackageManager)
+    , m_uiBuilt(false)
+    , m_packageManagerAttachPending(false)
+    , m_mainUiPlugin(nullptr)
+    , m_inBackground(buildUiOnShow)
     , m_trayIcon(nullptr)
     , m_trayIconMenu(nullptr)
     , m_showHideAction(nullptr)
     , m_quitAction(nullptr)
 {
     setupUi();
+    if (!buildUiOnShow) {
+        ensureUi();
+    }
     createTrayIcon();
 }
 
@@ -50,7 +68,7 @@ Window::~Window()
     }
 }
 
-void Window::setupUi()
+QString Window::uiPluginPath(const QString& name)
 {
     // Determine the appropriate plugin extension based on the platform
     QString pluginExtension;
@@ -63,56 +81,165 @@ void Window::setupUi()
     #endif
 
     QString pluginsDir = QCoreApplication::applicationDirPath() + "/../plugins/";
-    
-    // First, load the package_manager_ui plugin (now in subdirectory)
-    QString packageManagerPluginPath = pluginsDir + "package_manager_ui/package_manager_ui" + pluginExtension;
+    return pluginsDir + name + "/" + name + pluginExtension;
+}
+
+bool Window::hasStaticUiPlugin(const QString& name)
+{
+    return staticUiPluginIndex(name) >= 0;
+}
+
+QObject* Window::staticUiPlugin(const QString& name)
+{
+    const int index = staticUiPluginIndex(name);
+    return index >= 0 ? QPluginLoader::staticPlugins().at(index).instance() : nullptr;
+}
+
+int Window::staticUiPluginIndex(const QString& name)
+{
+#ifdef LOGOS_STATIC_UI_PLUGINS
+    QString className;
+    if (name == "main_ui") {
+        className = "MainUIPlugin";
+    }
+#ifdef PACKAGE_MANAGER_UI_PLUGIN_CLASS
+    if (name == "package_manager_ui") {
+        className = PACKAGE_MANAGER_UI_PLUGIN_CLASS;
+    }
+#endif
+    if (className.isEmpty()) {
+        return -1;
+    }
+    const QList<QStaticPlugin> plugins = QPluginLoader::staticPlugins();
+    for (int i = 0; i < plugins.size(); ++i) {
+        if (plugins.at(i).metaData().value("className").toString() == className) {
+            return i;
+        }
+    }
+#else
+    Q_UNUSED(name);
+#endif
+    return -1;
+}
+
+QWidget* Window::loadPackageManagerUi()
+{
+    // Load the package_manager_ui plugin (now in subdirectory)
+    QString packageManagerPluginPath = uiPluginPath("package_manager_ui");
+    StartupProfiler* profiler = StartupProfiler::instance();
     QPluginLoader packageManagerLoader(packageManagerPluginPath);
     QWidget* packageManagerWidget = nullptr;
     
-    if (packageManagerLoader.load()) {
-        QObject* pmPlugin = packageManagerLoader.instance();
-        if (pmPlugin) {
-            IComponent* component = qobject_cast<IComponent*>(pmPlugin);
-            if (component) {
-                packageManagerWidget = component->createWidget(m_logosAPI);
-                if (packageManagerWidget) {
-                    qDebug() << "Loaded package_manager_ui plugin successfully";
-                } else {
-                    qWarning() << "package_manager_ui plugin createWidget returned null";
-                }
+    profiler->begin("package_manager_ui.static");
+    QObject* pmPlugin = staticUiPlugin("package_manager_ui");
+    profiler->end("package_manager_ui.static");
+    if (pmPlugin) {
+        qDebug() << "Using statically linked package_manager_ui plugin";
+    } else {
+        profiler->begin("package_manager_ui.dlopen");
+        const bool packageManagerLoaded = packageManagerLoader.load();
+        profiler->end("package_manager_ui.dlopen");
+        if (packageManagerLoaded) {
+            pmPlugin = packageManagerLoader.instance();
+        } else {
+            qWarning() << "Failed to load package_manager_ui plugin:" << packageManagerLoader.errorString();
+        }
+    }
+
+    if (pmPlugin) {
+        IComponent* component = qobject_cast<IComponent*>(pmPlugin);
+        if (component) {
+            profiler->begin("package_manager_ui.createWidget");
+            packageManagerWidget = component->createWidget(m_logosAPI);
+            profiler->end("package_manager_ui.createWidget");
+            if (packageManagerWidget) {
+                qDebug() << "Loaded package_manager_ui plugin successfully";
             } else {
-                qWarning() << "package_manager_ui plugin does not implement IComponent";
+                qWarning() << "package_manager_ui plugin createWidget returned null";
             }
+        } else {
+            qWarning() << "package_manager_ui plugin does not implement IComponent";
         }
-    } else {
-        qWarning() << "Failed to load package_manager_ui plugin:" << packageManagerLoader.errorString();
     }
+    return packageManagerWidget;
+}
+
+void Window::attachPackageManagerUi()
+{
+    if (!m_uiBuilt) {
+        m_packageManagerAttachPending = true;
+        return;
+    }
+    m_packageManagerAttachPending = false;
+
+    QWidget* packageManagerWidget = loadPackageManagerUi();
+    // Pass the package manager widget to main_ui if it was loaded
+    if (packageManagerWidget && m_mainUiPlugin) {
+        QMetaObject::invokeMethod(m_mainUiPlugin, "setPackageManagerWidget",
+                                Qt::DirectConnection,
+                                Q_ARG(QWidget*, packageManagerWidget));
+    }
+}
+
+void Window::setupUi()
+{
+    // Set window title and size
+    setWindowTitle("Logos App");
+    resize(1024, 768);
+
+#ifdef Q_OS_MAC
+    setWindowFlags(windowFlags() | Qt::FramelessWindowHint);
+    setupMacOSDockReopen();
+    // Create title bar after resize() so it gets full width from the start
+    m_trafficLightsTitleBar = new TrafficLightsTitleBar(this);
+    m_trafficLightsTitleBar->setGeometry(0, 0, width(), TrafficLightsTitleBar::kTitleBarHeight);
+    m_trafficLightsTitleBar->show();
+    m_trafficLightsTitleBar->raise();
+#endif
+}
+
+void Window::ensureUi()
+{
+    if (m_uiBuilt) {
+        return;
+    }
+    m_uiBuilt = true;
+    StartupProfiler* profiler = StartupProfiler::instance();
 
     // Load the main_ui plugin with the appropriate extension (now in subdirectory)
-    QString mainUiPluginPath = pluginsDir + "main_ui/main_ui" + pluginExtension;
+    QString mainUiPluginPath = uiPluginPath("main_ui");
     QPluginLoader loader(mainUiPluginPath);
 
     QWidget* mainContent = nullptr;
-    QObject* mainUiPlugin = nullptr;
-
-    if (loader.load()) {
-        mainUiPlugin = loader.instance();
-        if (mainUiPlugin) {
-            // Try to create the main window using the plugin's createWidget method
-            QMetaObject::invokeMethod(mainUiPlugin, "createWidget",
-                                    Qt::DirectConnection,
-                                    Q_RETURN_ARG(QWidget*, mainContent),
-                                    Q_ARG(LogosAPI*, m_logosAPI));
+
+    profiler->begin("main_ui.static");
+    m_mainUiPlugin = staticUiPlugin("main_ui");
+    profiler->end("main_ui.static");
+    if (m_mainUiPlugin) {
+        qDebug() << "Using statically linked main_ui plugin";
+    } else {
+        profiler->begin("main_ui.dlopen");
+        if (loader.load()) {
+            m_mainUiPlugin = loader.instance();
         }
+        profiler->end("main_ui.dlopen");
+    }
+
+    if (m_mainUiPlugin) {
+        // Try to create the main window using the plugin's createWidget method
+        profiler->begin("main_ui.createWidget");
+        QMetaObject::invokeMethod(m_mainUiPlugin, "createWidget",
+                                Qt::DirectConnection,
+                                Q_RETURN_ARG(QWidget*, mainContent),
+                                Q_ARG(LogosAPI*, m_logosAPI));
+        profiler->end("main_ui.createWidget");
     }
 
     if (mainContent) {
         setCentralWidget(mainContent);
-        // Pass the package manager widget to main_ui if it was loaded
-        if (packageManagerWidget && mainUiPlugin) {
-            QMetaObject::invokeMethod(mainUiPlugin, "setPackageManagerWidget",
-                                    Qt::DirectConnection,
-                                    Q_ARG(QWidget*, packageManagerWidget));
+        // In deferred mode main() attaches the package manager after the first frame
+        if (!m_deferPackageManager || m_packageManagerAttachPending) {
+            attachPackageManagerUi();
         }
     } else {
         qWarning() << "================================================";
@@ -134,24 +261,28 @@ void Window::setupUi()
         qWarning() << "Failed to load main UI plugin from:" << mainUiPluginPath;
     }
 
-    // Set window title and size
-    setWindowTitle("Logos App");
-    resize(1024, 768);
-
 #ifdef Q_OS_MAC
-    setWindowFlags(windowFlags() | Qt::FramelessWindowHint);
-    setupMacOSDockReopen();
-    // Create title bar after resize() so it gets full width from the start
-    m_trafficLightsTitleBar = new TrafficLightsTitleBar(this);
-    m_trafficLightsTitleBar->setGeometry(0, 0, width(), TrafficLightsTitleBar::kTitleBarHeight);
-    m_trafficLightsTitleBar->show();
-    m_trafficLightsTitleBar->raise();
+    if (m_trafficLightsTitleBar) {
+        m_trafficLightsTitleBar->raise();
+    }
 #endif
 }
 
+void Window::setVisible(bool visible)
+{
+    // The UI is built on first show when the window started hidden
+    if (visible) {
+        ensureUi();
+    }
+    QMainWindow::setVisible(visible);
+}
+
 void Window::changeEvent(QEvent* event)
 {
     QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange && isVisible()) {
+        setInBackground(isMinimized());
+    }
 #ifdef Q_OS_MAC
     if (event->type() == QEvent::WindowStateChange) {
         const bool fullScreen = (windowState() & Qt::WindowFullScreen) != 0;
@@ -191,6 +322,34 @@ void Window::showEvent(QShowEvent* event)
 #ifdef Q_OS_MAC
     applyMacWindowRoundedCorners(this);
 #endif
+    if (!event->spontaneous() || !isMinimized()) {
+        setInBackground(false);
+    }
+}
+
+void Window::hideEvent(QHideEvent* event)
+{
+    QMainWindow::hideEvent(event);
+    // Spontaneous hide events come from the window system (e.g. minimizing)
+    if (!event->spontaneous()) {
+        setInBackground(true);
+    }
+}
+
+void Window::setInBackground(bool inBackground)
+{
+    if (m_inBackground == inBackground) {
+        return;
+    }
+    m_inBackground = inBackground;
+    qDebug() << (inBackground ? "Entering" : "Leaving") << "background mode";
+
+    // Lets main_ui suspend its QML rendering, timers and stats sampling
+    if (m_mainUiPlugin) {
+        QMetaObject::invokeMethod(m_mainUiPlugin, "setBackgroundMode", Qt::DirectConnection,
+                                  Q_ARG(bool, inBackground));
+    }
+    emit backgroundModeChanged(inBackground);
 }
 
 #ifdef Q_OS_MAC
@@ -239,6 +398,14 @@ void Window::createTrayIcon()
     m_trayIcon->show();
 }
 
+void Window::setStatusMessage(const QString& message)
+{
+    if (!m_trayIcon) {
+        return;
+    }
+    m_trayIcon->setToolTip(message.isEmpty() ? QString("Logos App") : QString("Logos App\n%1").arg(message));
+}
+
 void Window::setIcon()
 {
     if (!m_trayIcon) {
@@ -292,6 +459,32 @@ void Window::closeEvent(QCloseEvent *event)
     }
 }
 
+void Window::handleForwardedArguments(const QStringList& arguments)
+{
+    show();
+    raise();
+    activateWindow();
+
+    if (!m_mainUiPlugin) {
+        qWarning() << "Cannot handle forwarded arguments without the main UI plugin:" << arguments;
+        return;
+    }
+
+    static const QStringList installableSuffixes = {"lgx", "so", "dylib", "dll"};
+    for (const QString& argument : arguments) {
+        QFileInfo fileInfo(argument);
+        if (fileInfo.isFile() && installableSuffixes.contains(fileInfo.suffix().toLower())) {
+            qDebug() << "Installing forwarded plugin:" << argument;
+            QMetaObject::invokeMethod(m_mainUiPlugin, "installPlugin", Qt::DirectConnection,
+                                      Q_ARG(QString, fileInfo.absoluteFilePath()));
+        } else {
+            qDebug() << "Opening forwarded app:" << argument;
+            QMetaObject::invokeMethod(m_mainUiPlugin, "openApp", Qt::DirectConnection,
+                                      Q_ARG(QString, argument));
+        }
+    }
+}
+
 void Window::showHideWindow()
 {
     if (isVisible()) {
@@ -3,6 +3,8 @@
 
 #include <QMainWindow>
 #include <QSystemTrayIcon>
+#include <QString>
+#include <QStringList>
 
 class LogosAPI;
 class QMenu;
@@ -10,6 +12,7 @@ class QAction;
 class QCloseEvent;
 class QResizeEvent;
 class QShowEvent;
+class QHideEvent;
 class QWidget;
 
 class Window : public QMainWindow
@@ -18,14 +21,51 @@ class Window : public QMainWindow
 
 public:
     explicit Window(QWidget *parent = nullptr);
-    explicit Window(LogosAPI* logosAPI, QWidget *parent = nullptr);
+    // With deferPackageManager the package manager UI is left out of setupUi() and
+    // added later through attachPackageManagerUi(). With buildUiOnShow main_ui and
+    // its QML are not loaded until the window is first shown (tray-only start).
+    explicit Window(LogosAPI* logosAPI, bool deferPackageManager = false, bool buildUiOnShow = false,
+                    QWidget *parent = nullptr);
     ~Window();
 
+    // Path of a bundled UI plugin library, e.g. ../plugins/main_ui/main_ui.so
+    static QString uiPluginPath(const QString& name);
+
+    // Instance of a UI plugin linked into the executable (LOGOS_STATIC_UI_PLUGINS),
+    // or nullptr if the plugin has to be loaded from uiPluginPath()
+    static QObject* staticUiPlugin(const QString& name);
+    static bool hasStaticUiPlugin(const QString& name);
+
+    // Loads package_manager_ui and hands its widget to the main UI. If the main UI
+    // has not been built yet, this happens when it is.
+    void attachPackageManagerUi();
+
+    // Loads main_ui and builds the window contents if that has not happened yet
+    void ensureUi();
+    bool isUiBuilt() const { return m_uiBuilt; }
+
+    void setVisible(bool visible) override;
+
+    // Shown in the tray icon tooltip under the app name; empty clears it
+    void setStatusMessage(const QString& message);
+
+    // True while the window is hidden to the tray or minimized
+    bool isInBackground() const { return m_inBackground; }
+
+signals:
+    void backgroundModeChanged(bool inBackground);
+
+public slots:
+    // Arguments of a later launch: plugin packages/libraries are installed, anything
+    // else is taken as the name of an app to open
+    void handleForwardedArguments(const QStringList& arguments);
+
 protected:
     void changeEvent(QEvent *event) override;
     void closeEvent(QCloseEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
     void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
 
 private slots:
     void showHideWindow();
@@ -34,13 +74,21 @@ private slots:
 
 private:
     void setupUi();
+    static int staticUiPluginIndex(const QString& name);
+    QWidget* loadPackageManagerUi();
     void createTrayIcon();
     void setIcon();
+    void setInBackground(bool inBackground);
 #ifdef Q_OS_MAC
     void setupMacOSDockReopen();
 #endif
 
     LogosAPI* m_logosAPI;
+    bool m_deferPackageManager;
+    bool m_uiBuilt;
+    bool m_packageManagerAttachPending;
+    QObject* m_mainUiPlugin;
+    bool m_inBackground;
     QSystemTrayIcon* m_trayIcon;
     QMenu* m_trayIconMenu;
     QAction* m_showHideAction;
@@ -0,0 +1,119 @@
+#!/bin/bash
+# Compares startup cost of the dynamic and static UI plugin builds.
+#
+# Usage: ./bench-startup.sh [runs] [dynamic-result] [static-result]
+#   Build the two variants first:
+#     nix build .#app -o result
+#     nix build .#app-static -o result-static
+#
+# Each build is started <runs> times (default 5) with --startup-report. The app
+# is stopped once the report is written. The script prints the median of the
+# phases that differ between the variants: loading the UI plugin libraries
+# (dlopen, relocations, static initialisers) and the time to the first frame.
+# On Linux the dynamic loader statistics (LD_DEBUG=statistics) are also printed.
+
+RUNS="${1:-5}"
+DYNAMIC="${2:-./result}"
+STATIC="${3:-./result-static}"
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+OUT_DIR="$(mktemp -d "${TMPDIR:-/tmp}/logos-bench.XXXXXX")"
+
+if ! command -v python3 >/dev/null 2>&1; then
+    echo "Error: python3 is required to summarize the reports"
+    exit 1
+fi
+
+run_variant() {
+    local name="$1"
+    local result="$2"
+    local binary="$result/bin/logos-app"
+
+    if [ ! -x "$binary" ]; then
+        echo "Error: $binary not found (build the $name variant first)"
+        exit 1
+    fi
+
+    for i in $(seq 1 "$RUNS"); do
+        local report="$OUT_DIR/$name-$i.json"
+        local ldlog="$OUT_DIR/$name-$i.ld"
+        if [ "$(uname -s)" = "Linux" ]; then
+            LD_DEBUG=statistics LD_DEBUG_OUTPUT="$ldlog" \
+                "$binary" --multi-instance --startup-report "$report" >/dev/null 2>&1 &
+        else
+            "$binary" --multi-instance --startup-report "$report" >/dev/null 2>&1 &
+        fi
+        local pid=$!
+
+        # Wait up to 60s for the report, then stop the app
+        for _ in $(seq 1 600); do
+            [ -f "$report" ] && break
+            sleep 0.1
+        done
+        kill "$pid" 2>/dev/null
+        wait "$pid" 2>/dev/null
+        if [ ! -f "$report" ]; then
+            echo "Warning: $name run $i produced no report"
+        fi
+    done
+}
+
+echo "Benchmarking $RUNS runs per variant, reports in $OUT_DIR"
+run_variant dynamic "$DYNAMIC"
+run_variant static "$STATIC"
+
+python3 - "$OUT_DIR" "$RUNS" <<'PY'
+import glob, json, os, re, statistics, sys
+
+out_dir, runs = sys.argv[1], int(sys.argv[2])
+phases = [
+    "main_ui.preload", "package_manager_ui.preload",
+    "main_ui.static", "main_ui.dlopen", "main_ui.createWidget",
+    "package_manager_ui.static", "package_manager_ui.dlopen",
+    "window.create", "window.show",
+]
+
+def load(variant):
+    reports = []
+    for path in sorted(glob.glob(os.path.join(out_dir, f"{variant}-*.json"))):
+        with open(path) as f:
+            reports.append(json.load(f))
+    return reports
+
+def median_phase(reports, name):
+    values = [p["durationMs"] for r in reports for p in r["phases"]
+              if p["name"] == name and p.get("durationMs") is not None]
+    return statistics.median(values) if values else None
+
+def median_mark(reports, name):
+    values = [m["atMs"] for r in reports for m in r["marks"] if m["name"] == name]
+    return statistics.median(values) if values else None
+
+def ld_stats(variant):
+    relocations, times = [], []
+    for path in glob.glob(os.path.join(out_dir, f"{variant}-*.ld*")):
+        with open(path, errors="replace") as f:
+            text = f.read()
+        m = re.findall(r"final number of relocations:\s*(\d+)", text)
+        if m:
+            relocations.append(max(int(x) for x in m))
+        m = re.findall(r"total startup time in dynamic loader:\s*([\d.]+)\s*(\w+)", text)
+        if m:
+            times.append(m[0][0] + " " + m[0][1])
+    return relocations, times
+
+variants = {"dynamic": load("dynamic"), "static": load("static")}
+fmt = lambda v: "-" if v is None else f"{v:9.2f}"
+
+print()
+print(f"{'phase (median ms)':32} {'dynamic':>10} {'static':>10}")
+for name in phases:
+    print(f"{name:32} {fmt(median_phase(variants['dynamic'], name)):>10} {fmt(median_phase(variants['static'], name)):>10}")
+print(f"{'window.firstFrame (at)':32} {fmt(median_mark(variants['dynamic'], 'window.firstFrame')):>10} {fmt(median_mark(variants['static'], 'window.firstFrame')):>10}")
+
+for variant in ("dynamic", "static"):
+    relocations, times = ld_stats(variant)
+    if relocations:
+        print(f"{variant}: dynamic loader relocations (median) {int(statistics.median(relocations))}, "
+              f"initial load time {times[0] if times else '-'}")
+PY
@@ -83,6 +83,17 @@
             webviewAppPlugin = webviewAppPlugin;
           };
           
+          # App package with main_ui linked statically (development build)
+          appStatic = import ./nix/app.nix { 
+            inherit pkgs common src logosLiblogos logosSdk logosPackageManager logosCapabilityModule logosDesignSystem logosPackageLib;
+            counterPlugin = counterPlugin;
+            counterQmlPlugin = counterQmlPlugin;
+            mainUIPlugin = mainUIPlugin;
+            packageManagerUIPlugin = packageManagerUIPlugin;
+            webviewAppPlugin = webviewAppPlugin;
+            static = true;
+          };
+          
           # App package (distributed build for DMG/AppImage)
           appDistributed = import ./nix/app.nix { 
             inherit pkgs common src logosLiblogos logosSdk logosPackageManager logosCapabilityModule logosDesignSystem;
@@ -125,6 +136,7 @@
           package-manager-ui-plugin = packageManagerUIPlugin;
           webview-app-plugin = webviewAppPlugin;
           app = app;
+          app-static = appStatic;
           
           # Default package
           default = app;
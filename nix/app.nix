@@ -1,5 +1,9 @@
 # Builds the logos-app standalone application
-{ pkgs, common, src, logosLiblogos, logosSdk, logosPackageManager, logosCapabilityModule, logosDesignSystem, counterPlugin, counterQmlPlugin, mainUIPlugin, packageManagerUIPlugin, webviewAppPlugin }:
+# With static = true, main_ui is built from ./src and linked into LogosApp
+# (LOGOS_STATIC_UI_PLUGINS) instead of being installed to plugins/main_ui.
+{ pkgs, common, src, logosLiblogos, logosSdk, logosPackageManager, logosCapabilityModule, logosDesignSystem, counterPlugin, counterQmlPlugin, mainUIPlugin, packageManagerUIPlugin, webviewAppPlugin, static ? false, logosPackageLib ? null }:
+
+assert static -> logosPackageLib != null;
 
 let
   # webkitgtk became ABI-versioned; pick the newest available while staying
@@ -84,7 +88,14 @@ pkgs.stdenv.mkDerivation rec {
     elif [ -f "${logosSdk}/lib/liblogos_sdk.a" ]; then
       cp "${logosSdk}/lib/liblogos_sdk.a" ./logos-cpp-sdk/lib/
     fi
-    
+    ${pkgs.lib.optionalString static ''
+    # main_ui is compiled into the app: prepare its generated SDK wrappers as in main-ui.nix
+    mkdir -p ./src/generated_code
+    if [ -d "${logosPackageManager}/include" ]; then
+      cp -r "${logosPackageManager}/include"/* ./src/generated_code/
+    fi
+    logos-cpp-generator --metadata ${src}/src/metadata.json --general-only --output-dir ./src/generated_code
+    ''}
     runHook postPreConfigure
   '';
   
@@ -167,7 +178,7 @@ pkgs.stdenv.mkDerivation rec {
       -DCMAKE_INSTALL_RPATH="" \
       -DCMAKE_SKIP_BUILD_RPATH=TRUE \
       -DLOGOS_LIBLOGOS_ROOT=${logosLiblogos} \
-      -DLOGOS_CPP_SDK_ROOT=$(pwd)/logos-cpp-sdk
+      -DLOGOS_CPP_SDK_ROOT=$(pwd)/logos-cpp-sdk ${pkgs.lib.optionalString static "-DLOGOS_STATIC_UI_PLUGINS=ON -DLGX_ROOT=${logosPackageLib}"}
     
     runHook postConfigure
   '';
@@ -192,6 +203,10 @@ pkgs.stdenv.mkDerivation rec {
       cp build/LogosApp "$out/bin/LogosApp"
       echo "Installed LogosApp binary"
     fi
+    if [ -f "build/LogosHeadless" ]; then
+      cp build/LogosHeadless "$out/bin/LogosHeadless"
+      echo "Installed LogosHeadless binary"
+    fi
     
     # Copy the core binaries from liblogos
     if [ -f "${logosLiblogos}/bin/logoscore" ]; then
@@ -235,7 +250,9 @@ pkgs.stdenv.mkDerivation rec {
       cp -L "${counterPlugin}/lib/counter.$OS_EXT" "$out/plugins/counter/"
       echo "Copied counter.$OS_EXT to plugins/counter/"
     fi
-    if [ -f "${mainUIPlugin}/lib/main_ui.$OS_EXT" ]; then
+    if [ "${if static then "1" else ""}" = "1" ]; then
+      echo "main_ui is linked into LogosApp"
+    elif [ -f "${mainUIPlugin}/lib/main_ui.$OS_EXT" ]; then
       mkdir -p "$out/plugins/main_ui"
       cp -L "${mainUIPlugin}/lib/main_ui.$OS_EXT" "$out/plugins/main_ui/"
       echo "Copied main_ui.$OS_EXT to plugins/main_ui/"
@@ -1,5 +1,7 @@
 #include "LogosQmlBridge.h"
 
+#include <QDebug>
+#include <QElapsedTimer>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -7,13 +9,78 @@
 
 #include "logos_api.h"
 #include "logos_api_client.h"
+#include "ModuleCallDispatcher.h"
+#include "ModuleClientRegistry.h"
+#include "ModuleHealthMonitor.h"
+#include "ModuleLazyLoader.h"
+#include "ModuleResultCache.h"
+#include "SharedBlobStore.h"
 
 LogosQmlBridge::LogosQmlBridge(LogosAPI* api, QObject* parent)
     : QObject(parent)
     , m_logosAPI(api)
+    , m_nextCallId(1)
 {
 }
 
+LogosQmlBridge::~LogosQmlBridge()
+{
+    cancelAllCalls();
+    if (m_blobStore) {
+        for (const QString& blobId : std::as_const(m_blobIds)) {
+            m_blobStore->release(blobId);
+        }
+    }
+}
+
+void LogosQmlBridge::setLazyLoader(ModuleLazyLoader* loader, const QString& pluginName)
+{
+    if (m_lazyLoader) {
+        disconnect(m_lazyLoader, nullptr, this, nullptr);
+    }
+    m_lazyLoader = loader;
+    m_pluginName = pluginName;
+    if (loader) {
+        connect(loader, &ModuleLazyLoader::moduleReady, this, &LogosQmlBridge::onModuleReady);
+        connect(loader, &ModuleLazyLoader::moduleFailed, this, &LogosQmlBridge::onModuleFailed);
+    }
+}
+
+void LogosQmlBridge::setCallDispatcher(ModuleCallDispatcher* dispatcher)
+{
+    m_callDispatcher = dispatcher;
+}
+
+void LogosQmlBridge::setHealthMonitor(ModuleHealthMonitor* monitor)
+{
+    m_healthMonitor = monitor;
+}
+
+void LogosQmlBridge::setResultCache(ModuleResultCache* cache)
+{
+    m_resultCache = cache;
+}
+
+void LogosQmlBridge::setClientRegistry(ModuleClientRegistry* registry)
+{
+    m_clientRegistry = registry;
+}
+
+void LogosQmlBridge::setBlobStore(std::shared_ptr<SharedBlobStore> store)
+{
+    m_blobStore = std::move(store);
+}
+
+QString LogosQmlBridge::errorResult(const QString& error, const QString& module)
+{
+    QJsonObject result;
+    result["error"] = error;
+    if (!module.isEmpty()) {
+        result["module"] = module;
+    }
+    return QString::fromUtf8(QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
 QString LogosQmlBridge::callModule(const QString& module,
                                    const QString& method,
                                    const QVariantList& args)
@@ -25,17 +92,288 @@ QString LogosQmlBridge::callModule(const QString& module,
     // TODO: restrictions will go here, i.e is this plugin called to call this module and method?
     // will a way to track the origin
 
-    LogosAPIClient* client = m_logosAPI->getClient(module);
-    if (!client || !client->isConnected()) {
+    QVariant cached;
+    if (m_resultCache && m_resultCache->lookup(module, method, args, &cached)) {
+        return serializeResult(mapBlobs(module, cached));
+    }
+
+    QString unavailable;
+    if (m_healthMonitor && !m_healthMonitor->allowCall(module, &unavailable)) {
+        return errorResult(unavailable, module);
+    }
+
+    if (!connectedClient(module)) {
+        // The caller is expected to retry, or to use callModuleAsync() which waits
+        if (requestLazyLoad(module)) {
+            return errorResult("Module loading", module);
+        }
         return "{\"error\":\"Module not connected\"}";
     }
 
+    // Made here on the GUI thread, this call would overtake the module's queued calls
+    if (m_callDispatcher && m_callDispatcher->pendingCalls(module) > 0) {
+        return errorResult("Module busy", module);
+    }
+
+    return invoke(module, method, args);
+}
+
+int LogosQmlBridge::callModuleAsync(const QString& module,
+                                    const QString& method,
+                                    const QVariantList& args,
+                                    const QJSValue& callback,
+                                    int timeoutMs)
+{
+    return call(module, method, args, [this, module, callback](const QVariant& result, const QString& error) {
+        if (!callback.isCallable()) {
+            return;
+        }
+        const QString resultString = error.isEmpty() ? serializeResult(result) : errorResult(error, module);
+        const QJSValue returned = QJSValue(callback).call(QJSValueList{QJSValue(resultString)});
+        if (returned.isError()) {
+            qWarning() << "LogosQmlBridge: callback threw:" << returned.toString();
+        }
+    }, timeoutMs);
+}
+
+int LogosQmlBridge::call(const QString& module,
+                         const QString& method,
+                         const QVariantList& args,
+                         ResultCallback resultCallback,
+                         int timeoutMs)
+{
+    // Delivered on this object's thread while it is alive, so blobs are mapped for this plugin
+    const ResultCallback callback = [this, module, resultCallback](const QVariant& result, const QString& error) {
+        if (resultCallback) {
+            resultCallback(error.isEmpty() ? mapBlobs(module, result) : result, error);
+        }
+    };
+
+    if (!m_logosAPI) {
+        deliver(callback, QVariant(), "LogosAPI not available");
+        return 0;
+    }
+
+    QVariant cached;
+    if (m_resultCache && m_resultCache->lookup(module, method, args, &cached)) {
+        deliver(callback, cached, QString());
+        return 0;
+    }
+
+    const int callId = m_nextCallId++;
+    if (connectedClient(module)) {
+        dispatch(callId, module, method, args, callback, timeoutMs);
+        return callId;
+    }
+
+    if (!requestLazyLoad(module)) {
+        deliver(callback, QVariant(), "Module not connected");
+        return 0;
+    }
+    m_pendingCalls[module].append(PendingCall{callId, timeoutMs, method, args, callback});
+    return callId;
+}
+
+void LogosQmlBridge::cancelCall(int callId)
+{
+    if (m_dispatchedCalls.contains(callId)) {
+        if (m_callDispatcher) {
+            m_callDispatcher->cancel(m_dispatchedCalls.value(callId));
+        }
+        m_dispatchedCalls.remove(callId);
+        return;
+    }
+    for (QList<PendingCall>& calls : m_pendingCalls) {
+        for (int i = 0; i < calls.size(); ++i) {
+            if (calls.at(i).id == callId) {
+                calls.removeAt(i);
+                return;
+            }
+        }
+    }
+}
+
+void LogosQmlBridge::cancelAllCalls()
+{
+    m_pendingCalls.clear();
+    m_dispatchedCalls.clear();
+    if (m_callDispatcher) {
+        m_callDispatcher->cancelAll(this);
+    }
+}
+
+QString LogosQmlBridge::invoke(const QString& module, const QString& method, const QVariantList& args)
+{
+    QString error;
+    const QVariant result = invokeRemote(module, method, args, &error);
+    if (!error.isEmpty()) {
+        return errorResult(error);
+    }
+    return serializeResult(mapBlobs(module, result));
+}
+
+LogosAPIClient* LogosQmlBridge::connectedClient(const QString& module)
+{
+    if (m_clientRegistry) {
+        return m_clientRegistry->isConnected(module) ? m_clientRegistry->client(module) : nullptr;
+    }
+    LogosAPIClient* client = m_logosAPI->getClient(module);
+    return client && client->isConnected() ? client : nullptr;
+}
+
+QVariant LogosQmlBridge::invokeRemote(const QString& module, const QString& method, const QVariantList& args, QString* error)
+{
+    LogosAPIClient* client = connectedClient(module);
+    if (!client) {
+        if (m_healthMonitor) {
+            m_healthMonitor->recordFailure(module, "Module not connected", 0);
+        }
+        *error = "Module not connected";
+        return QVariant();
+    }
+    emit moduleCalled(module);
+    const quint64 cacheGeneration = m_resultCache ? m_resultCache->generation(module) : 0;
+    QElapsedTimer latency;
+    latency.start();
     QVariant result = client->invokeRemoteMethod(module, method, args);
     if (!result.isValid()) {
-        return "{\"error\":\"Invalid response\"}";
+        if (m_healthMonitor) {
+            m_healthMonitor->recordFailure(module, "Invalid response", latency.elapsed());
+        }
+        *error = "Invalid response";
+        return QVariant();
+    }
+    if (m_healthMonitor) {
+        m_healthMonitor->recordSuccess(module, latency.elapsed());
+    }
+    if (m_resultCache) {
+        m_resultCache->store(module, method, args, result, cacheGeneration);
+    }
+    return result;
+}
+
+void LogosQmlBridge::dispatch(int callId,
+                              const QString& module,
+                              const QString& method,
+                              const QVariantList& args,
+                              const ResultCallback& callback,
+                              int timeoutMs)
+{
+    if (!m_callDispatcher) {
+        // Without workers the call blocks here, as callModule() does
+        QString error;
+        const QVariant result = invokeRemote(module, method, args, &error);
+        deliver(callback, result, error);
+        return;
+    }
+    emit moduleCalled(module);
+    const quint64 cacheGeneration = m_resultCache ? m_resultCache->generation(module) : 0;
+    const quint64 dispatcherId = m_callDispatcher->call(module, method, args, this,
+        [this, callId, callback, module, method, args, cacheGeneration](const QVariant& result, const QString& error) {
+            m_dispatchedCalls.remove(callId);
+            if (error.isEmpty() && m_resultCache) {
+                m_resultCache->store(module, method, args, result, cacheGeneration);
+            }
+            if (callback) {
+                callback(result, error);
+            }
+        }, timeoutMs);
+    m_dispatchedCalls.insert(callId, dispatcherId);
+}
+
+bool LogosQmlBridge::requestLazyLoad(const QString& module)
+{
+    if (!m_lazyLoader || !m_lazyLoader->isEnabled()) {
+        return false;
     }
+    if (!m_lazyLoader->isLoading(module) && !m_lazyLoader->isKnown(module)) {
+        return false;
+    }
+    m_lazyLoader->request(module, m_pluginName);
+    return true;
+}
+
+void LogosQmlBridge::deliver(const ResultCallback& callback, const QVariant& result, const QString& error)
+{
+    if (!callback) {
+        return;
+    }
+    // Always asynchronous, so callers see the same ordering whether or not the module was loaded
+    QMetaObject::invokeMethod(this, [callback, result, error]() {
+        callback(result, error);
+    }, Qt::QueuedConnection);
+}
+
+void LogosQmlBridge::onModuleReady(const QString& module)
+{
+    const QList<PendingCall> calls = m_pendingCalls.take(module);
+    for (const PendingCall& call : calls) {
+        dispatch(call.id, module, call.method, call.args, call.callback, call.timeoutMs);
+    }
+}
+
+void LogosQmlBridge::onModuleFailed(const QString& module, const QString& error)
+{
+    const QList<PendingCall> calls = m_pendingCalls.take(module);
+    for (const PendingCall& call : calls) {
+        deliver(call.callback, QVariant(), error);
+    }
+}
 
-    return serializeResult(result);
+QByteArray LogosQmlBridge::blobData(const QString& blobId) const
+{
+    const std::shared_ptr<const SharedBlobStore::Blob> blob =
+        m_blobStore && m_blobIds.contains(blobId) ? m_blobStore->lookup(blobId) : nullptr;
+    if (!blob) {
+        return QByteArray();
+    }
+    return QByteArray(reinterpret_cast<const char*>(blob->data), blob->size);
+}
+
+void LogosQmlBridge::releaseBlob(const QString& blobId)
+{
+    if (m_blobStore && m_blobIds.remove(blobId)) {
+        m_blobStore->release(blobId);
+    }
+}
+
+QVariant LogosQmlBridge::mapBlobs(const QString& module, const QVariant& result)
+{
+    if (!m_blobStore) {
+        return result;
+    }
+    if (SharedBlobStore::isHandle(result)) {
+        QString error;
+        const QString blobId = m_blobStore->map(module, result.toMap(), &error);
+        if (blobId.isEmpty()) {
+            qWarning() << "LogosQmlBridge: cannot map blob from" << module << ":" << error;
+            QVariantMap failed;
+            failed["error"] = error;
+            QVariantMap handle;
+            handle["$blob"] = failed;
+            return handle;
+        }
+        m_blobIds.insert(blobId);
+        const std::shared_ptr<const SharedBlobStore::Blob> blob = m_blobStore->lookup(blobId);
+        qDebug() << "LogosQmlBridge: mapped" << blob->size << "byte blob for" << m_pluginName << ";"
+                 << m_blobStore->count() << "blobs," << m_blobStore->mappedBytes() << "bytes mapped";
+        return SharedBlobStore::describe(blobId, *blob);
+    }
+    if (result.typeId() == QMetaType::QVariantMap) {
+        QVariantMap map = result.toMap();
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            it.value() = mapBlobs(module, it.value());
+        }
+        return map;
+    }
+    if (result.typeId() == QMetaType::QVariantList) {
+        QVariantList list = result.toList();
+        for (QVariant& item : list) {
+            item = mapBlobs(module, item);
+        }
+        return list;
+    }
+    return result;
 }
 
 QString LogosQmlBridge::serializeResult(const QVariant& result) const
@@ -1,23 +1,126 @@
 #pragma once
 
+#include <QHash>
+#include <QJSValue>
+#include <QList>
 #include <QObject>
+#include <QPointer>
+#include <QSet>
 #include <QString>
 #include <QVariant>
 #include <QVariantList>
+#include <functional>
+#include <memory>
 
 class LogosAPI;
+class LogosAPIClient;
+class ModuleCallDispatcher;
+class ModuleClientRegistry;
+class ModuleHealthMonitor;
+class ModuleLazyLoader;
+class ModuleResultCache;
+class SharedBlobStore;
 
 class LogosQmlBridge : public QObject {
     Q_OBJECT
 public:
+    // error is empty on success
+    using ResultCallback = std::function<void(const QVariant& result, const QString& error)>;
+
     explicit LogosQmlBridge(LogosAPI* api, QObject* parent = nullptr);
+    ~LogosQmlBridge();
+
+    // Lets calls to known but unloaded modules load them on behalf of pluginName
+    void setLazyLoader(ModuleLazyLoader* loader, const QString& pluginName);
+    // Runs callModuleAsync() calls on the module's worker queue instead of the GUI thread
+    void setCallDispatcher(ModuleCallDispatcher* dispatcher);
+    // Fails callModule() at once for modules it considers unhealthy, and is told how calls went
+    void setHealthMonitor(ModuleHealthMonitor* monitor);
+    // Answers calls to cacheable methods from earlier results
+    void setResultCache(ModuleResultCache* cache);
+    // Resolved clients and connection state shared by all bridges
+    void setClientRegistry(ModuleClientRegistry* registry);
+    // Maps shared memory handles in results; see SharedBlobStore
+    void setBlobStore(std::shared_ptr<SharedBlobStore> store);
 
+    // Deprecated: blocks the GUI thread, use callModuleAsync(). Returns
+    // {"error":"Module loading",...} while a lazily loaded module comes up, and
+    // {"error":"Module busy",...} while async calls to the module are queued or running.
     Q_INVOKABLE QString callModule(const QString& module,
                                    const QString& method,
                                    const QVariantList& args = QVariantList());
 
+    // Calls callback(result) with the same result string as callModule(). With a call
+    // dispatcher the call does not block the GUI thread. Calls to a module that is
+    // being loaded are queued and replayed once it has connected. timeoutMs < 0 uses
+    // the dispatcher's default, 0 waits forever; a late call gets {"error":"Call timed out"}.
+    // Returns an id for cancelCall(), or 0 if the result was already decided.
+    Q_INVOKABLE int callModuleAsync(const QString& module,
+                                    const QString& method,
+                                    const QVariantList& args,
+                                    const QJSValue& callback,
+                                    int timeoutMs = -1);
+    // callModuleAsync() for C++ helpers of the main UI, with the unserialized result;
+    // same id and cancellation. The callback always runs later on this thread.
+    int call(const QString& module,
+             const QString& method,
+             const QVariantList& args,
+             ResultCallback callback,
+             int timeoutMs = -1);
+
+    // The callback of a cancelled call is never called
+    Q_INVOKABLE void cancelCall(int callId);
+    // Called when the plugin is closed; also done when the bridge is destroyed
+    void cancelAllCalls();
+
+    // Contents of a mapped blob, copied into a JS ArrayBuffer. Images are better
+    // shown through the blob's image://logosblob url, which does not copy.
+    Q_INVOKABLE QByteArray blobData(const QString& blobId) const;
+    // Unmaps a blob this plugin no longer needs; all are released with the plugin
+    Q_INVOKABLE void releaseBlob(const QString& blobId);
+
+signals:
+    // A call was sent to module; feeds the idle tracking of ModuleMemoryPolicy
+    void moduleCalled(const QString& module);
+
 private:
+    struct PendingCall {
+        int id;
+        int timeoutMs;
+        QString method;
+        QVariantList args;
+        ResultCallback callback;
+    };
+
+    QString invoke(const QString& module, const QString& method, const QVariantList& args);
+    // nullptr unless module is connected
+    LogosAPIClient* connectedClient(const QString& module);
+    QVariant invokeRemote(const QString& module, const QString& method, const QVariantList& args, QString* error);
+    void dispatch(int callId,
+                  const QString& module,
+                  const QString& method,
+                  const QVariantList& args,
+                  const ResultCallback& callback,
+                  int timeoutMs);
+    bool requestLazyLoad(const QString& module);
+    void deliver(const ResultCallback& callback, const QVariant& result, const QString& error);
+    void onModuleReady(const QString& module);
+    void onModuleFailed(const QString& module, const QString& error);
+    static QString errorResult(const QString& error, const QString& module = QString());
     QString serializeResult(const QVariant& result) const;
+    // Replaces the module's shared memory handles in result by mapped blob ids
+    QVariant mapBlobs(const QString& module, const QVariant& result);
 
     LogosAPI* m_logosAPI;
+    QPointer<ModuleLazyLoader> m_lazyLoader;
+    QPointer<ModuleCallDispatcher> m_callDispatcher;
+    QPointer<ModuleHealthMonitor> m_healthMonitor;
+    QPointer<ModuleResultCache> m_resultCache;
+    QPointer<ModuleClientRegistry> m_clientRegistry;
+    std::shared_ptr<SharedBlobStore> m_blobStore;
+    QSet<QString> m_blobIds;  // mapped for this plugin
+    QString m_pluginName;
+    QHash<QString, QList<PendingCall>> m_pendingCalls;  // waiting for a lazy load
+    QHash<int, quint64> m_dispatchedCalls;  // callModuleAsync id -> dispatcher call id
+    int m_nextCallId;
 };
@@ -1,8 +1,10 @@
 #include "MainContainer.h"
 #include "MainUIBackend.h"
 #include "mdiview.h"
+#include "StartupTrace.h"
 
 #include <QQuickWidget>
+#include <QQuickWindow>
 #include <QQmlEngine>
 #include <QQmlContext>
 #include <QQuickStyle>
@@ -14,6 +16,7 @@
 #include <QProcessEnvironment>
 #include <QColor>
 #include <QPalette>
+#include <QLabel>
 
 MainContainer::MainContainer(LogosAPI* logosAPI, QWidget* parent)
     : QWidget(parent)
@@ -23,14 +26,19 @@ MainContainer::MainContainer(LogosAPI* logosAPI, QWidget* parent)
     , m_contentStack(nullptr)
     , m_mdiView(nullptr)
     , m_contentWidget(nullptr)
+    , m_packageManagerPage(nullptr)
 {
     // Set QML style
     QQuickStyle::setStyle("Basic");
     
     // Create backend
+    StartupTrace::begin("main_ui.backend");
     m_backend = new MainUIBackend(m_logosAPI, this);
+    StartupTrace::end("main_ui.backend");
     
+    StartupTrace::begin("main_ui.setupUi");
     setupUi();
+    StartupTrace::end("main_ui.setupUi");
     
     // Connect section index changes
     connect(m_backend, &MainUIBackend::currentActiveSectionIndexChanged, 
@@ -118,7 +126,13 @@ void MainContainer::setupUi()
     }
     qDebug() << "Sidebar engine import paths:" << m_sidebarWidget->engine()->importPathList();
     m_sidebarWidget->rootContext()->setContextProperty("backend", m_backend);
-    m_sidebarWidget->setSource(resolveQmlUrl("qml/panels/SidebarPanel.qml"));
+    {
+        StartupTrace::Scope trace("main_ui.qml.SidebarPanel");
+        m_sidebarWidget->setSource(resolveQmlUrl("qml/MainUi/Panels/SidebarPanel.qml"));
+    }
+    connect(m_sidebarWidget, &QQuickWidget::frameSwapped, this, []() {
+        StartupTrace::mark("main_ui.sidebar.firstFrameSwapped");
+    }, Qt::SingleShotConnection);
     m_sidebarWidget->setMinimumWidth(60);
     m_sidebarWidget->setMaximumWidth(60);
     // set clear color to sidebar so that rounded corners don't show white
@@ -137,19 +151,15 @@ void MainContainer::setupUi()
     m_mdiView = new MdiView(m_contentStack);
     m_contentStack->addWidget(m_mdiView);
     
-    // Index 1: QML content views (Dashboard, Modules, PackageManager, Settings)
-    m_contentWidget = new QQuickWidget(m_contentStack);
-    m_contentWidget->setResizeMode(QQuickWidget::SizeRootObjectToView);
-    if (!qmlUiPath.isEmpty()) {
-        QString absPath = QDir(qmlUiPath).absolutePath();
-        m_contentWidget->engine()->addImportPath(absPath + "/qml");
-        m_contentWidget->engine()->addImportPath(absPath);
-    } else {
-        m_contentWidget->engine()->addImportPath("qrc:/qml");
-    }
-    m_contentWidget->rootContext()->setContextProperty("backend", m_backend);
-    m_contentWidget->setSource(resolveQmlUrl("qml/views/ContentViews.qml"));
-    m_contentStack->addWidget(m_contentWidget);
+    // Package manager page; a placeholder until the app provides the widget
+    QLabel* placeholder = new QLabel(tr("Loading package manager…"), m_contentStack);
+    placeholder->setAlignment(Qt::AlignCenter);
+    placeholder->setStyleSheet("color: #a0a0a0; font-size: 14px;");
+    m_packageManagerPage = placeholder;
+    m_contentStack->addWidget(m_packageManagerPage);
+
+    // QML content views (Dashboard, Modules, Settings) are created by
+    // ensureContentWidget() on first navigation
     
     // Add widgets to content layout
     contentLayout->addWidget(m_contentStack, 1);
@@ -159,25 +169,115 @@ void MainContainer::setupUi()
     m_mainLayout->addWidget(contentArea, 1);
     
     // Set initial state
-    m_contentStack->setCurrentIndex(0); // Show MdiView by default
+    m_contentStack->setCurrentWidget(m_mdiView); // Show MdiView by default
     
     // Set reasonable minimum size
     setMinimumSize(800, 600);
 }
 
+void MainContainer::ensureContentWidget()
+{
+    if (m_contentWidget) {
+        return;
+    }
+
+    QString qmlUiPath = QProcessEnvironment::systemEnvironment().value("QML_UI", "");
+
+    m_contentWidget = new QQuickWidget(m_contentStack);
+    m_contentWidget->setResizeMode(QQuickWidget::SizeRootObjectToView);
+    if (!qmlUiPath.isEmpty()) {
+        QString absPath = QDir(qmlUiPath).absolutePath();
+        m_contentWidget->engine()->addImportPath(absPath + "/qml");
+        m_contentWidget->engine()->addImportPath(absPath);
+    } else {
+        m_contentWidget->engine()->addImportPath("qrc:/qml");
+    }
+    m_contentWidget->rootContext()->setContextProperty("backend", m_backend);
+
+    // Views hidden for longer than this are unloaded again (0 keeps them loaded)
+    bool ok = false;
+    int unloadSeconds = qEnvironmentVariableIntValue("LOGOS_CONTENT_VIEW_UNLOAD_SECONDS", &ok);
+    if (!ok || unloadSeconds < 0) {
+        unloadSeconds = 300;
+    }
+    m_contentWidget->rootContext()->setContextProperty("contentViewUnloadMs", unloadSeconds * 1000);
+
+    {
+        // On first navigation, so usually after startup
+        StartupTrace::Scope trace("main_ui.qml.ContentViews");
+        m_contentWidget->setSource(resolveQmlUrl("qml/MainUi/Views/ContentViews.qml"));
+    }
+    m_contentStack->addWidget(m_contentWidget);
+}
+
 void MainContainer::onViewIndexChanged()
 {
     int sectionIndex = m_backend->currentActiveSectionIndex();
+    const QString sectionName = m_backend->sections().value(sectionIndex).toMap().value("name").toString();
     
-    qDebug() << "MainContainer: Active section index changed to" << sectionIndex;
+    qDebug() << "MainContainer: Active section index changed to" << sectionIndex << sectionName;
     
-    // Index 0 = Apps (show MdiView), Indices 1-3 = Dashboard/Modules/Settings (show QML)
-    if (sectionIndex == 0) {
+    if (sectionName == "Apps") {
         // Apps workspace - show MdiView (C++ widget)
-        m_contentStack->setCurrentIndex(0);
+        m_contentStack->setCurrentWidget(m_mdiView);
+    } else if (sectionName == "Packages") {
+        // Package manager (C++ widget from package_manager_ui, or its placeholder)
+        m_contentStack->setCurrentWidget(m_packageManagerPage);
     } else {
         // Dashboard, Modules, or Settings - show QML content
-        m_contentStack->setCurrentIndex(1);
+        ensureContentWidget();
+        m_contentStack->setCurrentWidget(m_contentWidget);
+    }
+}
+
+void MainContainer::setPackageManagerWidget(QWidget* widget)
+{
+    if (!widget || widget == m_packageManagerPage) {
+        return;
+    }
+
+    const bool wasCurrent = m_contentStack->currentWidget() == m_packageManagerPage;
+    QWidget* placeholder = m_packageManagerPage;
+    const int index = m_contentStack->indexOf(placeholder);
+
+    m_packageManagerPage = widget;
+    m_contentStack->insertWidget(index, widget);
+    m_contentStack->removeWidget(placeholder);
+    placeholder->deleteLater();
+
+    if (wasCurrent) {
+        m_contentStack->setCurrentWidget(widget);
+    }
+
+    m_backend->onPackageManagerReady();
+    qDebug() << "MainContainer: Package manager UI attached";
+}
+
+void MainContainer::setBackgroundMode(bool enabled)
+{
+    setQuickWidgetSuspended(m_sidebarWidget, enabled);
+    setQuickWidgetSuspended(m_contentWidget, enabled);
+    for (QQuickWidget* widget : m_backend->qmlPluginWidgets()) {
+        setQuickWidgetSuspended(widget, enabled);
+    }
+    m_backend->setBackgroundMode(enabled);
+}
+
+void MainContainer::setQuickWidgetSuspended(QQuickWidget* widget, bool suspended)
+{
+    if (!widget) {
+        return;
+    }
+    // Hidden QQuickWidgets already skip rendering; this also stops repaints queued by
+    // bindings that keep changing while the window is away
+    widget->setUpdatesEnabled(!suspended);
+
+    // Opt-in: give back scene graph and component cache memory, at the cost of a
+    // slower first frame when the window is shown again
+    if (suspended && qEnvironmentVariableIntValue("LOGOS_BACKGROUND_TRIM_QML") == 1) {
+        widget->quickWindow()->releaseResources();
+        widget->engine()->trimComponentCache();
+        widget->engine()->collectGarbage();
     }
 }
 
@@ -26,6 +26,12 @@ public:
     // Get the LogosAPI instance
     LogosAPI* getLogosAPI() const { return m_logosAPI; }
 
+    // Replaces the "Packages" placeholder with the package manager UI
+    void setPackageManagerWidget(QWidget* widget);
+
+    // Called while the app window is hidden to the tray or minimized
+    void setBackgroundMode(bool enabled);
+
 private slots:
     void onViewIndexChanged();
     void onNavigateToApps();
@@ -35,6 +41,8 @@ private slots:
 
 private:
     void setupUi();
+    void ensureContentWidget();
+    void setQuickWidgetSuspended(QQuickWidget* widget, bool suspended);
     QUrl resolveQmlUrl(const QString& qmlFile);
     
     // Main layout
@@ -49,8 +57,12 @@ private:
     // MdiView (C++ widget for Apps)
     MdiView* m_mdiView;
     
-    // Content views (QML for Dashboard, Modules, PackageManager, Settings)
+    // Content views (QML for Dashboard, Modules, PackageManager, Settings),
+    // created on first navigation away from Apps
     QQuickWidget* m_contentWidget;
+
+    // Package manager UI, or a placeholder until the app provides it
+    QWidget* m_packageManagerPage;
     
     // Backend
     MainUIBackend* m_backend;
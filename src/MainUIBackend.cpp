@@ -10,6 +10,7 @@
 #include <QFileInfo>
 #include <QLibraryInfo>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QQmlContext>
 #include <QQuickWidget>
 #include <QQmlEngine>
@@ -22,9 +23,20 @@
 #include "LogosQmlBridge.h"
 #include "logos_sdk.h"
 #include "token_manager.h"
-#include "restricted/DenyAllNAMFactory.h"
-#include "restricted/RestrictedUrlInterceptor.h"
+#include "restricted/QmlEnginePool.h"
+#include "QmlPluginCache.h"
+#include "ModuleLeaseManager.h"
+#include "ModuleLazyLoader.h"
+#include "ModuleClientRegistry.h"
+#include "ModuleMemoryPolicy.h"
+#include "ModuleCallDispatcher.h"
+#include "ModuleHealthMonitor.h"
+#include "ModuleResultCache.h"
+#include "RemoteListModel.h"
+#include "SharedBlobStore.h"
 #include "lgx.h"
+#include "LogosCoreGate.h"
+#include "StartupTrace.h"
 
 extern "C" {
     char* logos_core_get_module_stats();
@@ -37,6 +49,19 @@ MainUIBackend::MainUIBackend(LogosAPI* logosAPI, QObject* parent)
     , m_logosAPI(logosAPI)
     , m_ownsLogosAPI(false)
     , m_statsTimer(nullptr)
+    , m_qmlEnginePool(nullptr)
+    , m_qmlPluginCache(nullptr)
+    , m_moduleLeases(nullptr)
+    , m_moduleClients(nullptr)
+    , m_moduleLazyLoader(nullptr)
+    , m_memoryPolicy(nullptr)
+    , m_callDispatcher(nullptr)
+    , m_healthMonitor(nullptr)
+    , m_resultCache(nullptr)
+    , m_nextCoreModuleCallId(1)
+    , m_coreModulesRefreshQueued(false)
+    , m_packageEventsSubscribed(false)
+    , m_backgroundMode(false)
 {
     if (!m_logosAPI) {
         m_logosAPI = new LogosAPI("core", this);
@@ -44,16 +69,51 @@ MainUIBackend::MainUIBackend(LogosAPI* logosAPI, QObject* parent)
     }
     
     initializeSections();
+
+    m_qmlPluginCache = new QmlPluginCache(this);
+    qmlRegisterType<RemoteListModel>("Logos.Models", 1, 0, "RemoteListModel");
+
+    m_qmlEnginePool = new QmlEnginePool(QmlEnginePool::modeFromEnvironment(), this);
+    m_blobStore = std::make_shared<SharedBlobStore>();
+    m_qmlEnginePool->setBlobStore(m_blobStore);
+    // Fill the widget pool once the window has drawn its first frame, so it never
+    // competes with startup; right away if that already happened or there is no profiler
+    QObject* profiler = StartupTrace::profiler();
+    if (profiler && !profiler->property("firstFramePainted").toBool()) {
+        connect(profiler, SIGNAL(firstFrame()), this, SLOT(prewarmQmlWidgets()));
+    } else {
+        prewarmQmlWidgets();
+    }
     
+    m_moduleLeases = new ModuleLeaseManager(this);
+    connect(m_moduleLeases, &ModuleLeaseManager::unloadRequested, this, &MainUIBackend::unloadUnusedCoreModule);
+    m_moduleClients = new ModuleClientRegistry(m_logosAPI, this);
+    m_moduleLazyLoader = new ModuleLazyLoader(m_logosAPI, m_moduleLeases, m_moduleClients, this);
+    m_memoryPolicy = new ModuleMemoryPolicy(m_moduleLeases, this);
+    connect(m_memoryPolicy, &ModuleMemoryPolicy::unloadRequested, this, [this](const QString& module, const QString&) {
+        unloadCoreModule(module);
+    });
+    m_healthMonitor = new ModuleHealthMonitor(this);
+    connect(m_healthMonitor, &ModuleHealthMonitor::healthChanged, this, &MainUIBackend::coreModulesChanged);
+    connect(m_moduleLazyLoader, &ModuleLazyLoader::moduleReady, m_healthMonitor, &ModuleHealthMonitor::forget);
+    m_callDispatcher = new ModuleCallDispatcher(this);
+    m_callDispatcher->setHealthMonitor(m_healthMonitor);
+    m_resultCache = new ModuleResultCache(m_logosAPI, &m_callDispatcher->policy(), this);
+    connect(m_moduleLazyLoader, &ModuleLazyLoader::moduleReady, m_resultCache, &ModuleResultCache::forget);
+
     m_statsTimer = new QTimer(this);
     connect(m_statsTimer, &QTimer::timeout, this, &MainUIBackend::updateModuleStats);
     m_statsTimer->start(2000);
+    connect(m_moduleLazyLoader, &ModuleLazyLoader::moduleReady, this, &MainUIBackend::updateModuleStats);
     
     refreshUiModules();
     refreshCoreModules();
     refreshLauncherApps();
     
     subscribeToPackageInstallationEvents();
+
+    // Precompile plugins once startup has settled
+    scheduleQmlPluginPrecompile(5000);
     
     qDebug() << "MainUIBackend created";
 }
@@ -78,11 +138,11 @@ void MainUIBackend::subscribeToPackageInstallationEvents()
         return;
     }
     
-    LogosAPIClient* client = m_logosAPI->getClient("package_manager");
-    if (!client || !client->isConnected()) {
+    if (!m_moduleClients->isConnected("package_manager")) {
         return;
     }
     
+    m_packageEventsSubscribed = true;
     LogosModules logos(m_logosAPI);
     logos.package_manager.on("packageInstallationFinished", [this](const QVariantList& data) {
         if (data.size() < 3) {
@@ -95,11 +155,46 @@ void MainUIBackend::subscribeToPackageInstallationEvents()
                 refreshUiModules();
                 refreshCoreModules();
                 refreshLauncherApps();
+                scheduleQmlPluginPrecompile();
             });
         }
     });
 }
 
+void MainUIBackend::onPackageManagerReady()
+{
+    // The package manager may come up after the backend was created (deferred startup)
+    if (!m_packageEventsSubscribed) {
+        subscribeToPackageInstallationEvents();
+    }
+    refreshUiModules();
+    refreshCoreModules();
+    refreshLauncherApps();
+}
+
+void MainUIBackend::setBackgroundMode(bool enabled)
+{
+    if (m_backgroundMode == enabled) {
+        return;
+    }
+    m_backgroundMode = enabled;
+
+    if (enabled) {
+        // Nothing shows the stats while hidden; the memory policy still needs them now and then
+        if (m_memoryPolicy->isEnabled()) {
+            m_statsTimer->start(30000);
+        } else {
+            m_statsTimer->stop();
+        }
+    } else {
+        updateModuleStats();
+        m_statsTimer->start(2000);
+    }
+
+    qDebug() << "MainUIBackend: background mode" << (enabled ? "on" : "off");
+    emit backgroundModeChanged();
+}
+
 void MainUIBackend::initializeSections()
 {
     auto makeSection = [](const QString& name, const QString& iconPath, const QString& type) {
@@ -114,7 +209,8 @@ void MainUIBackend::initializeSections()
         makeSection("Apps", "qrc:/icons/tent.png", "workspace"),
         makeSection("Dashboard", "qrc:/icons/dashboard.png", "view"),
         makeSection("Modules", "qrc:/icons/module.png", "view"),
-        makeSection("Settings", "qrc:/icons/settings.png", "view")
+        makeSection("Settings", "qrc:/icons/settings.png", "view"),
+        makeSection("Packages", "qrc:/icons/add-button.png", "view")
     };
 }
 
@@ -125,7 +221,7 @@ int MainUIBackend::currentActiveSectionIndex() const
 
 void MainUIBackend::setCurrentActiveSectionIndex(int index)
 {
-    // Valid indices: 0-3 (Apps, Dashboard, Modules, Settings)
+    // Valid indices: 0-4 (Apps, Dashboard, Modules, Settings, Packages)
     if (m_currentActiveSectionIndex != index && index >= 0 && index < m_sections.size()) {
         m_currentActiveSectionIndex = index;
         emit currentActiveSectionIndexChanged();
@@ -175,21 +271,29 @@ void MainUIBackend::loadUiModule(const QString& moduleName)
         return;
     }
     
-    // Load core module dependencies from metadata
+    // Load core module dependencies from metadata. The app holds them while it is
+    // open; they are released when it is unloaded or closed, or if loading fails.
     QJsonObject metadata = readPluginMetadata(moduleName);
     QJsonArray dependencies = metadata.value("dependencies").toArray();
     if (!dependencies.isEmpty() && m_logosAPI) {
-        LogosModules logos(m_logosAPI);
+        QStringList coreDependencies;
         for (const QJsonValue& dep : dependencies) {
-            QString depName = dep.toString();
-            if (!depName.isEmpty()) {
-                qDebug() << "Loading core module dependency for UI module" << moduleName << ":" << depName;
-                bool success = logos.core_manager.loadPlugin(depName);
-                if (!success) {
-                    qWarning() << "Failed to load core module dependency" << depName << "for UI module" << moduleName;
-                    return;
-                }
+            if (!dep.toString().isEmpty()) {
+                coreDependencies << dep.toString();
+            }
+        }
+        m_moduleLeases->acquire(moduleName, coreDependencies, loadedCoreModuleNames());
+
+        LogosModules logos(m_logosAPI);
+        for (const QString& depName : coreDependencies) {
+            qDebug() << "Loading core module dependency for UI module" << moduleName << ":" << depName;
+            bool success = logos.core_manager.loadPlugin(depName);
+            if (!success) {
+                qWarning() << "Failed to load core module dependency" << depName << "for UI module" << moduleName;
+                m_moduleLeases->release(moduleName);
+                return;
             }
+            m_moduleClients->warmUp(depName);
         }
     }
     
@@ -203,57 +307,52 @@ void MainUIBackend::loadUiModule(const QString& moduleName)
 
         if (!QFile::exists(qmlFilePath)) {
             qWarning() << "Main QML file does not exist for plugin" << moduleName << ":" << qmlFilePath;
+            m_moduleLeases->release(moduleName);
             return;
         }
 
-        QQuickWidget* qmlWidget = new QQuickWidget;
-        qmlWidget->setResizeMode(QQuickWidget::SizeRootObjectToView);
-        QQmlEngine* engine = qmlWidget->engine();
-        if (engine) {
-            QStringList importPaths;
-            importPaths << QStringLiteral("qrc:/qt-project.org/imports");
-            importPaths << QStringLiteral("qrc:/qt/qml");
-            importPaths << pluginPath;     // Plugin-local imports only
-            qDebug() << "=======================> QML import paths:" << importPaths;
-            engine->setImportPathList(importPaths);
-
-            QStringList pluginPaths;
-            // note: commented out to keep this list empty to lock the plugin down
-            // could cause issues with other QML components but it's unclear the moment
-            //const QString qtPluginPath = QLibraryInfo::path(QLibraryInfo::PluginsPath);
-            //if (!qtPluginPath.isEmpty()) {
-            //    pluginPaths << qtPluginPath;  // Required for QtQuick C++ backends
-            //}
-            qDebug() << "=======================> QML plugin paths:" << pluginPaths;
-            engine->setPluginPathList(pluginPaths);
-
-            engine->setNetworkAccessManagerFactory(new DenyAllNAMFactory());
-            QStringList allowedRoots;
-            // allowedRoots << QStringLiteral("qrc:/qt/qml");
-            allowedRoots << pluginPath;
-            qDebug() << "=======================> QML allowed roots:" << allowedRoots;
-            engine->addUrlInterceptor(new RestrictedUrlInterceptor(allowedRoots));
-            qDebug() << "=======================> QML base url:" << QUrl::fromLocalFile(pluginPath + "/");
-            engine->setBaseUrl(QUrl::fromLocalFile(pluginPath + "/"));
-        }
-        LogosQmlBridge* bridge = new LogosQmlBridge(m_logosAPI, qmlWidget);
-        qmlWidget->rootContext()->setContextProperty("logos", bridge);
-        qmlWidget->setSource(QUrl::fromLocalFile(qmlFilePath));
+        QElapsedTimer launchTimer;
+        launchTimer.start();
+        const QString firstFramePhase = "uiModule." + moduleName + ".firstFrame";
+        StartupTrace::begin(firstFramePhase);
+        m_pendingQmlPrecompile.removeAll(moduleName);
+        // Content hashing and compiling are left to idle time; a miss loads from source
+        const bool cacheHit = m_qmlPluginCache->looksUpToDate(moduleName, pluginPath);
+        qDebug() << "QML cache check for" << moduleName << (cacheHit ? "(hit)" : "(stale, loading from source)")
+                 << "took" << launchTimer.elapsed() << "ms";
+        // Shared engine membership is the host's call; a user-installed plugin of the
+        // same name never inherits it
+        const QString bundledRoot = QDir(pluginsDirectory()).canonicalPath() + "/";
+        const bool bundled = QFileInfo(pluginPath).canonicalFilePath().startsWith(bundledRoot);
+        QQuickWidget* qmlWidget = m_qmlEnginePool->createPluginWidget(moduleName, pluginPath, bundled);
+        LogosQmlBridge* bridge = createQmlBridge(moduleName, qmlWidget);
+        m_qmlEnginePool->contextFor(qmlWidget)->setContextProperty("logos", bridge);
+        QList<QQmlError> errors;
+        const bool loaded = m_qmlEnginePool->setPluginSource(qmlWidget, QUrl::fromLocalFile(qmlFilePath), &errors);
         qmlWidget->setWindowIcon(QIcon(getPluginIconPath(pluginPath, true)));
 
-        if (qmlWidget->status() == QQuickWidget::Error) {
+        if (!loaded) {
             qWarning() << "Failed to load QML plugin" << moduleName;
-            const auto errors = qmlWidget->errors();
             for (const QQmlError& error : errors) {
                 qWarning() << error.toString();
             }
             qmlWidget->deleteLater();
+            m_moduleLeases->release(moduleName);
+            StartupTrace::end(firstFramePhase);
             return;
         }
 
+        // Render offscreen before the tab appears so it never shows blank
+        m_qmlEnginePool->renderFirstFrame(qmlWidget);
+        StartupTrace::end(firstFramePhase);
+        qDebug() << "Time to first frame for QML UI module" << moduleName << ":" << launchTimer.elapsed() << "ms";
+
         m_qmlPluginWidgets[moduleName] = qmlWidget;
         m_uiModuleWidgets[moduleName] = qmlWidget;
         m_loadedApps.insert(moduleName);
+        if (!cacheHit) {
+            queueQmlPluginPrecompile(moduleName, 5000);
+        }
 
         emit uiModulesChanged();
         emit launcherAppsChanged();
@@ -268,12 +367,14 @@ void MainUIBackend::loadUiModule(const QString& moduleName)
     QPluginLoader loader(pluginPath);
     if (!loader.load()) {
         qDebug() << "Failed to load plugin:" << moduleName << "-" << loader.errorString();
+        m_moduleLeases->release(moduleName);
         return;
     }
     
     QObject* plugin = loader.instance();
     if (!plugin) {
         qDebug() << "Failed to get plugin instance:" << moduleName << "-" << loader.errorString();
+        m_moduleLeases->release(moduleName);
         return;
     }
     
@@ -281,6 +382,7 @@ void MainUIBackend::loadUiModule(const QString& moduleName)
     if (!component) {
         qDebug() << "Failed to cast plugin to IComponent:" << moduleName;
         loader.unload();
+        m_moduleLeases->release(moduleName);
         return;
     }
     
@@ -288,6 +390,7 @@ void MainUIBackend::loadUiModule(const QString& moduleName)
     if (!componentWidget) {
         qDebug() << "Component returned null widget:" << moduleName;
         loader.unload();
+        m_moduleLeases->release(moduleName);
         return;
     }
     
@@ -336,6 +439,7 @@ void MainUIBackend::unloadUiModule(const QString& moduleName)
     m_uiModuleWidgets.remove(moduleName);
     m_qmlPluginWidgets.remove(moduleName);
     m_loadedApps.remove(moduleName);
+    releaseCoreModules(moduleName);
     
     emit uiModulesChanged();
     emit launcherAppsChanged();
@@ -363,6 +467,7 @@ void MainUIBackend::onPluginWindowClosed(const QString& pluginName)
 
     // Called when user closes the plugin window (tab X or subwindow close). The MDI
     // subwindow and plugin widget are already destroyed
+    releaseCoreModules(pluginName);
     if (m_loadedUiModules.contains(pluginName)) {
         m_loadedUiModules.remove(pluginName);
         m_uiModuleWidgets.remove(pluginName);
@@ -388,8 +493,7 @@ QVariantList MainUIBackend::coreModules() const
         return modules;
     }
     
-    LogosAPIClient* coreManagerClient = m_logosAPI->getClient("core_manager");
-    if (!coreManagerClient || !coreManagerClient->isConnected()) {
+    if (!m_moduleClients->isConnected("core_manager")) {
         qWarning() << "Core manager client is not available";
         return modules;
     }
@@ -403,6 +507,8 @@ QVariantList MainUIBackend::coreModules() const
         QVariantMap module;
         module["name"] = name;
         module["isLoaded"] = pluginObj["loaded"].toBool();
+        module["health"] = m_healthMonitor->health(name);
+        module["cache"] = m_resultCache->stats(name);
         
         if (m_moduleStats.contains(name)) {
             module["cpu"] = m_moduleStats[name]["cpu"];
@@ -427,8 +533,7 @@ void MainUIBackend::loadCoreModule(const QString& moduleName)
         return;
     }
     
-    LogosAPIClient* coreManagerClient = m_logosAPI->getClient("core_manager");
-    if (!coreManagerClient || !coreManagerClient->isConnected()) {
+    if (!m_moduleClients->isConnected("core_manager")) {
         qWarning() << "Core manager client is not available";
         return;
     }
@@ -438,6 +543,13 @@ void MainUIBackend::loadCoreModule(const QString& moduleName)
     
     if (success) {
         qDebug() << "Successfully loaded core module:" << moduleName;
+        // Loaded by hand; stays until unloaded by hand
+        m_moduleLeases->pin(moduleName);
+        m_moduleClients->warmUp(moduleName);
+        m_healthMonitor->forget(moduleName);
+        m_resultCache->forget(moduleName);
+        // Picks up the module's process, which its memfd blob handles must come from
+        updateModuleStats();
         emit coreModulesChanged();
     } else {
         qDebug() << "Failed to load core module:" << moduleName;
@@ -453,8 +565,7 @@ void MainUIBackend::unloadCoreModule(const QString& moduleName)
         return;
     }
     
-    LogosAPIClient* coreManagerClient = m_logosAPI->getClient("core_manager");
-    if (!coreManagerClient || !coreManagerClient->isConnected()) {
+    if (!m_moduleClients->isConnected("core_manager")) {
         qWarning() << "Core manager client is not available";
         return;
     }
@@ -464,12 +575,86 @@ void MainUIBackend::unloadCoreModule(const QString& moduleName)
     
     if (success) {
         qDebug() << "Successfully unloaded core module:" << moduleName;
+        m_moduleLeases->forget(moduleName);
+        m_memoryPolicy->forgetModule(moduleName);
+        m_moduleClients->forget(moduleName);
+        m_healthMonitor->forget(moduleName);
+        m_resultCache->forget(moduleName);
+        m_blobStore->forgetModule(moduleName);
         emit coreModulesChanged();
     } else {
         qDebug() << "Failed to unload core module:" << moduleName;
     }
 }
 
+LogosQmlBridge* MainUIBackend::createQmlBridge(const QString& pluginName, QObject* parent)
+{
+    LogosQmlBridge* bridge = new LogosQmlBridge(m_logosAPI, parent);
+    m_qmlBridges.insert(pluginName, bridge);
+    bridge->setLazyLoader(m_moduleLazyLoader, pluginName);
+    bridge->setCallDispatcher(m_callDispatcher);
+    bridge->setHealthMonitor(m_healthMonitor);
+    bridge->setResultCache(m_resultCache);
+    bridge->setClientRegistry(m_moduleClients);
+    bridge->setBlobStore(m_blobStore);
+    connect(bridge, &LogosQmlBridge::moduleCalled, m_memoryPolicy, &ModuleMemoryPolicy::noteModuleCall);
+    return bridge;
+}
+
+void MainUIBackend::releaseCoreModules(const QString& uiModuleName)
+{
+    // The widget may be deleted later; its calls must not deliver until then
+    if (LogosQmlBridge* bridge = m_qmlBridges.take(uiModuleName)) {
+        bridge->cancelAllCalls();
+    }
+    m_moduleLazyLoader->dropHolder(uiModuleName);
+    m_moduleLeases->release(uiModuleName);
+}
+
+QSet<QString> MainUIBackend::loadedCoreModuleNames() const
+{
+    QSet<QString> loaded;
+    if (!m_logosAPI) {
+        return loaded;
+    }
+    if (!m_moduleClients->isConnected("core_manager")) {
+        return loaded;
+    }
+    LogosModules logos(m_logosAPI);
+    for (const QJsonValue& val : logos.core_manager.getKnownPlugins()) {
+        const QJsonObject pluginObj = val.toObject();
+        if (pluginObj["loaded"].toBool()) {
+            loaded.insert(pluginObj["name"].toString());
+        }
+    }
+    return loaded;
+}
+
+void MainUIBackend::unloadUnusedCoreModule(const QString& moduleName)
+{
+    if (!m_logosAPI) {
+        return;
+    }
+    if (!m_moduleClients->isConnected("core_manager")) {
+        qWarning() << "Core manager client is not available";
+        return;
+    }
+
+    LogosModules logos(m_logosAPI);
+    if (logos.core_manager.unloadPlugin(moduleName)) {
+        qDebug() << "Unloaded unused core module:" << moduleName;
+        m_moduleLeases->forget(moduleName);
+        m_memoryPolicy->forgetModule(moduleName);
+        m_moduleClients->forget(moduleName);
+        m_healthMonitor->forget(moduleName);
+        m_resultCache->forget(moduleName);
+        m_blobStore->forgetModule(moduleName);
+        emit coreModulesChanged();
+    } else {
+        qWarning() << "Failed to unload unused core module:" << moduleName;
+    }
+}
+
 void MainUIBackend::refreshCoreModules()
 {
     QString libExtension;
@@ -481,12 +666,12 @@ void MainUIBackend::refreshCoreModules()
     libExtension = "*.so";
 #endif
     
+    QStringList pluginPaths;
     QDir modulesDir(modulesDirectory());
     if (modulesDir.exists()) {
         QStringList entries = modulesDir.entryList(QStringList() << libExtension, QDir::Files);
         for (const QString& entry : entries) {
-            QString fullPath = modulesDir.absoluteFilePath(entry);
-            logos_core_process_plugin(fullPath.toUtf8().constData());
+            pluginPaths << modulesDir.absoluteFilePath(entry);
         }
     }
     
@@ -497,23 +682,75 @@ void MainUIBackend::refreshCoreModules()
         if (userModulesDirObj.exists()) {
             QStringList entries = userModulesDirObj.entryList(QStringList() << libExtension, QDir::Files);
             for (const QString& entry : entries) {
-                QString fullPath = userModulesDirObj.absoluteFilePath(entry);
-                logos_core_process_plugin(fullPath.toUtf8().constData());
+                pluginPaths << userModulesDirObj.absoluteFilePath(entry);
             }
         }
     }
+
+    // A module load holds the gate until its host is up; retry rather than freeze the GUI
+    if (!LogosCoreGate::mutex().tryLock()) {
+        if (!m_coreModulesRefreshQueued) {
+            m_coreModulesRefreshQueued = true;
+            QTimer::singleShot(250, this, [this]() {
+                m_coreModulesRefreshQueued = false;
+                refreshCoreModules();
+            });
+        }
+        return;
+    }
+    for (const QString& pluginPath : std::as_const(pluginPaths)) {
+        logos_core_process_plugin(pluginPath.toUtf8().constData());
+    }
+    LogosCoreGate::mutex().unlock();
+
+    for (const QString& pluginPath : std::as_const(pluginPaths)) {
+        readCoreModuleMetadata(pluginPath);
+    }
+    m_memoryPolicy->setModuleDependencies(m_coreModuleDependencies);
     
     emit coreModulesChanged();
 }
 
+QJsonObject MainUIBackend::coreModuleMetadata(const QString& pluginPath)
+{
+    const QFileInfo info(pluginPath);
+    CoreModuleMetadata& cached = m_coreModuleMetadata[pluginPath];
+    if (cached.size != info.size() || cached.modified != info.lastModified()) {
+        cached.size = info.size();
+        cached.modified = info.lastModified();
+        cached.metadata = QPluginLoader(pluginPath).metaData().value("MetaData").toObject();
+    }
+    return cached.metadata;
+}
+
+void MainUIBackend::readCoreModuleMetadata(const QString& pluginPath)
+{
+    const QJsonObject meta = coreModuleMetadata(pluginPath);
+    const QString name = meta.value("name").toString();
+    if (name.isEmpty()) {
+        return;
+    }
+    // Modules may declare caching and single-flight options for their own methods
+    if (meta.value("callPolicy").isObject()) {
+        m_callDispatcher->policy().setModuleDefaults(name, meta.value("callPolicy").toObject());
+    }
+    QStringList dependencies;
+    for (const QJsonValue& value : meta.value("dependencies").toArray()) {
+        if (!value.toString().isEmpty()) {
+            dependencies << value.toString();
+        }
+    }
+    m_coreModuleDependencies.insert(name, dependencies);
+}
+
 QString MainUIBackend::getCoreModuleMethods(const QString& moduleName)
 {
     if (!m_logosAPI) {
         return "[]";
     }
     
-    LogosAPIClient* client = m_logosAPI->getClient(moduleName);
-    if (!client || !client->isConnected()) {
+    LogosAPIClient* client = m_moduleClients->client(moduleName);
+    if (!client || !m_moduleClients->isConnected(moduleName)) {
         return "[]";
     }
     
@@ -533,10 +770,22 @@ QString MainUIBackend::callCoreModuleMethod(const QString& moduleName, const QSt
         return "{\"error\": \"LogosAPI not available\"}";
     }
     
-    LogosAPIClient* client = m_logosAPI->getClient(moduleName);
-    if (!client || !client->isConnected()) {
+    QString unavailable;
+    if (!m_healthMonitor->allowCall(moduleName, &unavailable)) {
+        QJsonObject error;
+        error["error"] = unavailable;
+        return QJsonDocument(error).toJson(QJsonDocument::Compact);
+    }
+
+    LogosAPIClient* client = m_moduleClients->client(moduleName);
+    if (!client || !m_moduleClients->isConnected(moduleName)) {
         return "{\"error\": \"Module not connected\"}";
     }
+    // Made here on the GUI thread, this call would overtake the module's queued calls
+    if (m_callDispatcher->pendingCalls(moduleName) > 0) {
+        return "{\"error\": \"Module busy\"}";
+    }
+    m_memoryPolicy->noteModuleCall(moduleName);
     
     QJsonDocument argsDoc = QJsonDocument::fromJson(argsJson.toUtf8());
     QJsonArray argsArray = argsDoc.array();
@@ -547,6 +796,8 @@ QString MainUIBackend::callCoreModuleMethod(const QString& moduleName, const QSt
     }
     
     QVariant result;
+    QElapsedTimer latency;
+    latency.start();
     if (args.isEmpty()) {
         result = client->invokeRemoteMethod(moduleName, methodName);
     } else if (args.size() == 1) {
@@ -558,6 +809,11 @@ QString MainUIBackend::callCoreModuleMethod(const QString& moduleName, const QSt
     } else {
         return "{\"error\": \"Too many arguments\"}";
     }
+    if (result.isValid()) {
+        m_healthMonitor->recordSuccess(moduleName, latency.elapsed());
+    } else {
+        m_healthMonitor->recordFailure(moduleName, "Invalid response", latency.elapsed());
+    }
     
     QJsonObject wrapper;
     wrapper["result"] = QJsonValue::fromVariant(result);
@@ -565,6 +821,61 @@ QString MainUIBackend::callCoreModuleMethod(const QString& moduleName, const QSt
     return resultDoc.toJson(QJsonDocument::Compact);
 }
 
+int MainUIBackend::callCoreModuleMethodAsync(const QString& moduleName, const QString& methodName, const QString& argsJson, const QJSValue& callback, int timeoutMs)
+{
+    auto deliver = [callback](const QString& result) {
+        if (callback.isCallable()) {
+            QJSValue(callback).call(QJSValueList{QJSValue(result)});
+        }
+    };
+    // Like the dispatcher's results, errors reach the callback after this returns
+    auto deliverLater = [this, deliver](const QString& result) {
+        QMetaObject::invokeMethod(this, [deliver, result]() {
+            deliver(result);
+        }, Qt::QueuedConnection);
+    };
+
+    if (!m_logosAPI) {
+        deliverLater("{\"error\": \"LogosAPI not available\"}");
+        return 0;
+    }
+    if (!m_moduleClients->isConnected(moduleName)) {
+        deliverLater("{\"error\": \"Module not connected\"}");
+        return 0;
+    }
+    m_memoryPolicy->noteModuleCall(moduleName);
+
+    QVariantList args;
+    for (const QJsonValue& val : QJsonDocument::fromJson(argsJson.toUtf8()).array()) {
+        args.append(val.toVariant());
+    }
+
+    const int callId = m_nextCoreModuleCallId++;
+    const quint64 dispatcherId = m_callDispatcher->call(moduleName, methodName, args, this,
+        [this, callId, deliver](const QVariant& result, const QString& error) {
+            m_coreModuleCalls.remove(callId);
+            QJsonObject wrapper;
+            if (error.isEmpty()) {
+                wrapper["result"] = QJsonValue::fromVariant(result);
+            } else {
+                wrapper["error"] = error;
+            }
+            deliver(QString::fromUtf8(QJsonDocument(wrapper).toJson(QJsonDocument::Compact)));
+        }, timeoutMs);
+    if (dispatcherId == 0) {
+        return 0;
+    }
+    m_coreModuleCalls.insert(callId, dispatcherId);
+    return callId;
+}
+
+void MainUIBackend::cancelCoreModuleCall(int callId)
+{
+    if (m_coreModuleCalls.contains(callId)) {
+        m_callDispatcher->cancel(m_coreModuleCalls.take(callId));
+    }
+}
+
 QVariantList MainUIBackend::launcherApps() const
 {
     QVariantList apps;
@@ -676,6 +987,8 @@ void MainUIBackend::installPluginFromPath(const QString& filePath)
     
     emit uiModulesChanged();
     emit launcherAppsChanged();
+
+    scheduleQmlPluginPrecompile();
 }
 
 void MainUIBackend::openInstallCoreModuleDialog()
@@ -960,9 +1273,63 @@ QString MainUIBackend::getPluginIconPath(const QString& pluginPath, bool forWidg
     return exists ? QUrl::fromLocalFile(filePath).toString() : (iconPath.startsWith(":/") ? "qrc" + iconPath : QString());
 }
 
+void MainUIBackend::scheduleQmlPluginPrecompile(int delayMs)
+{
+    if (QmlPluginCache::isDiskCacheDisabled()) {
+        return;
+    }
+
+    for (const QString& pluginName : findAvailableUiPlugins()) {
+        if (isQmlPlugin(pluginName) && !m_qmlPluginWidgets.contains(pluginName)) {
+            queueQmlPluginPrecompile(pluginName, delayMs);
+        }
+    }
+}
+
+void MainUIBackend::queueQmlPluginPrecompile(const QString& pluginName, int delayMs)
+{
+    if (QmlPluginCache::isDiskCacheDisabled() || m_pendingQmlPrecompile.contains(pluginName)) {
+        return;
+    }
+
+    const bool idle = m_pendingQmlPrecompile.isEmpty();
+    m_pendingQmlPrecompile.append(pluginName);
+    // One plugin per event loop pass so the UI stays responsive
+    if (idle) {
+        QTimer::singleShot(delayMs, this, &MainUIBackend::precompileNextQmlPlugin);
+    }
+}
+
+void MainUIBackend::prewarmQmlWidgets()
+{
+    // One widget per event loop pass from here on
+    m_qmlEnginePool->setPrewarmTarget(QmlEnginePool::prewarmCountFromEnvironment());
+}
+
+void MainUIBackend::precompileNextQmlPlugin()
+{
+    if (m_pendingQmlPrecompile.isEmpty()) {
+        return;
+    }
+
+    const QString pluginName = m_pendingQmlPrecompile.takeFirst();
+    m_qmlPluginCache->ensureFresh(pluginName, getPluginPath(pluginName));
+
+    if (!m_pendingQmlPrecompile.isEmpty()) {
+        QTimer::singleShot(0, this, &MainUIBackend::precompileNextQmlPlugin);
+    } else {
+        m_qmlPluginCache->releaseCompileEngine();
+    }
+}
+
 void MainUIBackend::updateModuleStats()
 {
+    // Skipped while a module load holds the gate; the next tick samples again
+    if (!LogosCoreGate::mutex().tryLock()) {
+        return;
+    }
     char* stats_json = logos_core_get_module_stats();
+    LogosCoreGate::mutex().unlock();
     if (!stats_json) {
         return;
     }
@@ -984,6 +1351,8 @@ void MainUIBackend::updateModuleStats()
         modulesArray = root["modules"].toArray();
     }
     
+    QHash<QString, double> moduleMemory;
+    QHash<QString, qint64> modulePids;
     for (const QJsonValue& val : modulesArray) {
         QJsonObject moduleObj = val.toObject();
         QString name = moduleObj["name"].toString();
@@ -1000,8 +1369,15 @@ void MainUIBackend::updateModuleStats()
             stats["cpu"] = QString::number(cpu, 'f', 1);
             stats["memory"] = QString::number(memory, 'f', 1);
             m_moduleStats[name] = stats;
+            moduleMemory.insert(name, memory);
+            const qint64 pid = moduleObj["pid"].toInteger();
+            if (pid > 0) {
+                modulePids.insert(name, pid);
+            }
         }
     }
+    m_memoryPolicy->setModuleMemory(moduleMemory);
+    m_blobStore->setModulePids(modulePids);
     
     emit coreModulesChanged();
 }
@@ -6,14 +6,30 @@
 #include <QStringList>
 #include <QMap>
 #include <QJsonObject>
+#include <QDateTime>
 #include <QSet>
+#include <QHash>
+#include <QPointer>
+#include <QJSValue>
 #include <QTimer>
 #include <QPluginLoader>
+#include <memory>
 #include "logos_api.h"
 #include "logos_api_client.h"
 #include "IComponent.h"
 
 class QQuickWidget;
+class QmlEnginePool;
+class QmlPluginCache;
+class ModuleLeaseManager;
+class ModuleLazyLoader;
+class ModuleClientRegistry;
+class ModuleMemoryPolicy;
+class ModuleCallDispatcher;
+class ModuleHealthMonitor;
+class ModuleResultCache;
+class SharedBlobStore;
+class LogosQmlBridge;
 
 class MainUIBackend : public QObject {
     Q_OBJECT
@@ -31,6 +47,9 @@ class MainUIBackend : public QObject {
     // App Launcher
     Q_PROPERTY(QVariantList launcherApps READ launcherApps NOTIFY launcherAppsChanged)
 
+    // True while the main window is hidden to the tray or minimized
+    Q_PROPERTY(bool backgroundMode READ backgroundMode NOTIFY backgroundModeChanged)
+
 public:
     explicit MainUIBackend(LogosAPI* logosAPI = nullptr, QObject* parent = nullptr);
     ~MainUIBackend();
@@ -48,6 +67,14 @@ public:
     // App Launcher
     QVariantList launcherApps() const;
 
+    bool backgroundMode() const { return m_backgroundMode; }
+
+    // The "logos" object of a QML plugin; loads modules on first use when lazy loading is enabled
+    LogosQmlBridge* createQmlBridge(const QString& pluginName, QObject* parent);
+
+    // Widgets of the QML plugins that are currently loaded
+    QList<QQuickWidget*> qmlPluginWidgets() const { return m_qmlPluginWidgets.values(); }
+
 public slots:
     // Navigation
     void setCurrentActiveSectionIndex(int index);
@@ -67,8 +94,15 @@ public slots:
     void loadCoreModule(const QString& moduleName);
     void unloadCoreModule(const QString& moduleName);
     Q_INVOKABLE void refreshCoreModules();
+    // Deprecated: blocks the GUI thread, call "getMethods" with callCoreModuleMethodAsync()
     Q_INVOKABLE QString getCoreModuleMethods(const QString& moduleName);
+    // Deprecated: blocks the GUI thread, use callCoreModuleMethodAsync(). Returns
+    // {"error": "Module busy"} while async calls to the module are queued or running.
     Q_INVOKABLE QString callCoreModuleMethod(const QString& moduleName, const QString& methodName, const QString& argsJson);
+    // Same result string as callCoreModuleMethod(), passed to callback without blocking the GUI thread.
+    // Returns an id for cancelCoreModuleCall(), or 0 if the result was already decided.
+    Q_INVOKABLE int callCoreModuleMethodAsync(const QString& moduleName, const QString& methodName, const QString& argsJson, const QJSValue& callback, int timeoutMs = -1);
+    Q_INVOKABLE void cancelCoreModuleCall(int callId);
     Q_INVOKABLE void installCoreModuleFromPath(const QString& filePath);
     Q_INVOKABLE void openInstallCoreModuleDialog();
     
@@ -81,12 +115,19 @@ public slots:
     
     // Called when a plugin window is closed from MdiView
     void onPluginWindowClosed(const QString& pluginName);
+    
+    // Called once the package manager core module and UI are available
+    void onPackageManagerReady();
+
+    // Suspends stats polling while the window is hidden
+    void setBackgroundMode(bool enabled);
 
 signals:
     void currentActiveSectionIndexChanged();
     void uiModulesChanged();
     void coreModulesChanged();
     void launcherAppsChanged();
+    void backgroundModeChanged();
     void navigateToApps();
     
     // Signals for C++ MdiView coordination
@@ -94,6 +135,10 @@ signals:
     void pluginWindowRemoveRequested(QWidget* widget);
     void pluginWindowActivateRequested(QWidget* widget);
 
+private slots:
+    // Connected by name to the app's StartupProfiler::firstFrame
+    void prewarmQmlWidgets();
+
 private:
     void initializeSections();
     void subscribeToPackageInstallationEvents();
@@ -108,6 +153,16 @@ private:
     QJsonObject readPluginMetadata(const QString& pluginName) const;
     void updateModuleStats();
     QString getPluginIconPath(const QString& pluginPath, bool forWidgetIcon = false) const;
+    void scheduleQmlPluginPrecompile(int delayMs = 0);
+    void queueQmlPluginPrecompile(const QString& pluginName, int delayMs = 0);
+    void precompileNextQmlPlugin();
+    QSet<QString> loadedCoreModuleNames() const;
+    // Module plugin metadata, read again only when the file changed
+    QJsonObject coreModuleMetadata(const QString& pluginPath);
+    // Call policy and dependencies declared in a module's metadata
+    void readCoreModuleMetadata(const QString& pluginPath);
+    void unloadUnusedCoreModule(const QString& moduleName);
+    void releaseCoreModules(const QString& uiModuleName);
     
     // Navigation state
     int m_currentActiveSectionIndex;
@@ -117,10 +172,31 @@ private:
     QMap<QString, IComponent*> m_loadedUiModules;
     QMap<QString, QWidget*> m_uiModuleWidgets;
     QMap<QString, QQuickWidget*> m_qmlPluginWidgets;
+    QmlEnginePool* m_qmlEnginePool;
+    QmlPluginCache* m_qmlPluginCache;
+    QStringList m_pendingQmlPrecompile;
     
     // Core Modules state
     QTimer* m_statsTimer;
+    ModuleLeaseManager* m_moduleLeases;  // core modules held by open UI apps
+    ModuleClientRegistry* m_moduleClients;  // resolved clients and their connection state
+    ModuleLazyLoader* m_moduleLazyLoader;
+    ModuleMemoryPolicy* m_memoryPolicy;  // unloads idle modules over the memory budget
+    ModuleCallDispatcher* m_callDispatcher;  // per-module worker queues for remote calls
+    ModuleHealthMonitor* m_healthMonitor;  // circuit breaker per core module
+    ModuleResultCache* m_resultCache;  // cached results of pure read methods
+    std::shared_ptr<SharedBlobStore> m_blobStore;  // also held by the QML image providers
+    QHash<QString, QPointer<LogosQmlBridge>> m_qmlBridges;  // by QML plugin name
+    QHash<int, quint64> m_coreModuleCalls;  // callCoreModuleMethodAsync id -> dispatcher call id
+    int m_nextCoreModuleCallId;
     QMap<QString, QVariantMap> m_moduleStats;  // Stores per-module CPU/memory stats
+    struct CoreModuleMetadata {
+        QDateTime modified;
+        qint64 size = -1;
+        QJsonObject metadata;
+    };
+    QHash<QString, CoreModuleMetadata> m_coreModuleMetadata;  // by plugin path
+    QHash<QString, QStringList> m_coreModuleDependencies;  // by module name
     
     // App Launcher state
     QSet<QString> m_loadedApps;
@@ -128,4 +204,7 @@ private:
     // LogosAPI
     LogosAPI* m_logosAPI;
     bool m_ownsLogosAPI;
+    bool m_coreModulesRefreshQueued;  // retried while another core call holds LogosCoreGate
+    bool m_packageEventsSubscribed;
+    bool m_backgroundMode;
 };
@@ -0,0 +1,518 @@
+#include "ModuleCallDispatcher.h"
+#include "ModuleHealthMonitor.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRemoteObjectReplica>
+#include <QThreadStorage>
+#include <QTimer>
+#include <utility>
+
+#include "logos_api.h"
+#include "logos_api_client.h"
+
+namespace {
+
+// LogosAPI objects belong to the thread that made them; each pool thread keeps one
+QThreadStorage<LogosAPI*> workerApi;
+
+int environmentValue(const char* name, int fallback, int minimum)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok && value >= minimum ? value : fallback;
+}
+
+}
+
+bool ModuleCallDispatcher::Call::hasLiveWaiter() const
+{
+    for (const Waiter& waiter : waiters) {
+        if (waiter.context) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ModuleCallDispatcher::ModuleCallDispatcher(QObject* parent)
+    : QObject(parent)
+    , m_delivering(false)
+    , m_invoker(&ModuleCallDispatcher::invokeOnWorker)
+    , m_nextCallId(1)
+    , m_sharedCalls(0)
+    , m_defaultConcurrency(environmentValue("LOGOS_MODULE_CALL_CONCURRENCY", 1, 1))
+    , m_defaultTimeoutMs(environmentValue("LOGOS_MODULE_CALL_TIMEOUT_MS", 30000, 0))
+{
+    m_pool.setMaxThreadCount(environmentValue("LOGOS_MODULE_CALL_THREADS", 4, 1));
+    // Keep threads, and with them their connections, for the life of the app
+    m_pool.setExpiryTimeout(-1);
+    m_policy.load();
+}
+
+ModuleCallDispatcher::~ModuleCallDispatcher()
+{
+    // Calls that have not started yet are skipped; running ones report back to this object
+    for (ModuleQueue& queue : m_queues) {
+        for (Call& call : queue.started) {
+            call.abandoned->store(true);
+        }
+    }
+    m_pool.waitForDone();
+}
+
+void ModuleCallDispatcher::setHealthMonitor(ModuleHealthMonitor* monitor)
+{
+    if (m_healthMonitor) {
+        disconnect(m_healthMonitor, nullptr, this, nullptr);
+    }
+    m_healthMonitor = monitor;
+    if (monitor) {
+        connect(monitor, &ModuleHealthMonitor::probeRequested, this, &ModuleCallDispatcher::runProbe);
+    }
+}
+
+void ModuleCallDispatcher::setInvoker(Invoker invoker)
+{
+    m_invoker = invoker ? std::move(invoker) : Invoker(&ModuleCallDispatcher::invokeOnWorker);
+}
+
+void ModuleCallDispatcher::reloadPolicy()
+{
+    m_policy.load();
+}
+
+void ModuleCallDispatcher::setConcurrency(const QString& module, int maxRunning)
+{
+    m_queues[module].maxRunning = qMax(0, maxRunning);
+    startCalls(module);
+}
+
+int ModuleCallDispatcher::concurrency(const QString& module) const
+{
+    const auto it = m_queues.constFind(module);
+    return it != m_queues.constEnd() && it->maxRunning > 0 ? it->maxRunning : m_defaultConcurrency;
+}
+
+int ModuleCallDispatcher::pendingCalls(const QString& module) const
+{
+    const auto it = m_queues.constFind(module);
+    return it == m_queues.constEnd() ? 0 : it->waiting.size() + it->started.size();
+}
+
+QString ModuleCallDispatcher::callKey(const QString& module, const QString& method, const QVariantList& args)
+{
+    // QJsonObject keeps its keys sorted, so maps with the same entries serialize the same
+    const QByteArray canonicalArgs = QJsonDocument(QJsonArray::fromVariantList(args)).toJson(QJsonDocument::Compact);
+    return module + '\n' + method + '\n' + QString::fromUtf8(canonicalArgs);
+}
+
+quint64 ModuleCallDispatcher::call(const QString& module,
+                                   const QString& method,
+                                   const QVariantList& args,
+                                   QObject* context,
+                                   Callback callback,
+                                   int timeoutMs)
+{
+    Waiter waiter;
+    waiter.context = context;
+    waiter.callback = std::move(callback);
+
+    QString reason;
+    if (m_healthMonitor && !m_healthMonitor->allowCall(module, &reason)) {
+        // Still asynchronous, like every other outcome
+        QMetaObject::invokeMethod(this, [waiter, reason]() {
+            deliver(waiter, QVariant(), reason);
+        }, Qt::QueuedConnection);
+        return 0;
+    }
+
+    Call call;
+    call.method = method;
+    call.args = args;
+    if (m_policy.singleFlight(module, method)) {
+        call.key = callKey(module, method, args);
+    }
+    return enqueue(module, call, waiter, timeoutMs);
+}
+
+void ModuleCallDispatcher::runProbe(const QString& module)
+{
+    // Any answer from the module will do; every module has getMethods
+    Call call;
+    call.method = "getMethods";
+    call.probe = true;
+    Waiter waiter;
+    waiter.context = this;
+    waiter.callback = [this, module](const QVariant&, const QString& error) {
+        if (m_healthMonitor) {
+            m_healthMonitor->recordProbe(module, error.isEmpty(), error);
+        }
+    };
+    enqueue(module, call, waiter, 5000);
+}
+
+quint64 ModuleCallDispatcher::enqueue(const QString& module, Call call, Waiter waiter, int timeoutMs)
+{
+    waiter.id = m_nextCallId++;
+    m_callModules.insert(waiter.id, module);
+
+    const int deadlineMs = timeoutMs < 0 ? m_defaultTimeoutMs : timeoutMs;
+    if (deadlineMs > 0) {
+        const quint64 callId = waiter.id;
+        QTimer::singleShot(deadlineMs, this, [this, callId]() { expire(callId); });
+    }
+
+    // Join an identical call that has not returned yet
+    const auto inFlight = call.key.isEmpty() ? m_inFlight.constEnd() : m_inFlight.constFind(call.key);
+    if (inFlight != m_inFlight.constEnd()) {
+        ModuleQueue& queue = m_queues[inFlight->first];
+        const quint64 sequence = inFlight->second;
+        auto started = queue.started.find(sequence);
+        if (started != queue.started.end()) {
+            started->waiters.append(waiter);
+            ++m_sharedCalls;
+            return waiter.id;
+        }
+        for (Call& waitingCall : queue.waiting) {
+            if (waitingCall.sequence == sequence) {
+                waitingCall.waiters.append(waiter);
+                ++m_sharedCalls;
+                return waiter.id;
+            }
+        }
+    }
+
+    ModuleQueue& queue = m_queues[module];
+    call.sequence = queue.nextSequence++;
+    call.abandoned = std::make_shared<std::atomic<bool>>(false);
+    call.waiters.append(waiter);
+    if (!call.key.isEmpty()) {
+        m_inFlight.insert(call.key, qMakePair(module, call.sequence));
+    }
+    queue.waiting.append(call);
+    startCalls(module);
+    return waiter.id;
+}
+
+void ModuleCallDispatcher::cancel(quint64 callId)
+{
+    const QString module = m_callModules.value(callId);
+    Waiter waiter;
+    Call call;
+    bool lastWaiter = false;
+    if (abandon(callId, &waiter, &lastWaiter, &call)) {
+        qDebug() << "ModuleCallDispatcher: cancelled" << module << call.method;
+    }
+    flushDeliveries();
+}
+
+void ModuleCallDispatcher::cancelAll(QObject* context)
+{
+    QList<quint64> callIds;
+    for (const ModuleQueue& queue : std::as_const(m_queues)) {
+        for (const Call& call : queue.waiting) {
+            for (const Waiter& waiter : call.waiters) {
+                if (waiter.context == context) {
+                    callIds << waiter.id;
+                }
+            }
+        }
+        for (const Call& call : queue.started) {
+            for (const Waiter& waiter : call.waiters) {
+                if (waiter.context == context) {
+                    callIds << waiter.id;
+                }
+            }
+        }
+    }
+    for (quint64 callId : callIds) {
+        Waiter waiter;
+        Call call;
+        bool lastWaiter = false;
+        abandon(callId, &waiter, &lastWaiter, &call);
+    }
+    flushDeliveries();
+}
+
+void ModuleCallDispatcher::expire(quint64 callId)
+{
+    const QString module = m_callModules.value(callId);
+    Waiter waiter;
+    Call call;
+    bool lastWaiter = false;
+    if (!abandon(callId, &waiter, &lastWaiter, &call)) {
+        return;  // Already delivered
+    }
+    qWarning() << "ModuleCallDispatcher:" << module << call.method << "timed out";
+    // Counted once per remote call, when nobody waits for it any more
+    if (m_healthMonitor && lastWaiter && !call.probe) {
+        m_healthMonitor->recordFailure(module, "Call timed out", 0);
+    }
+    queueDelivery(waiter, QVariant(), "Call timed out");
+    flushDeliveries();
+}
+
+ModuleCallDispatcher::Call* ModuleCallDispatcher::findCall(const QString& module, quint64 callId)
+{
+    ModuleQueue& queue = m_queues[module];
+    for (Call& call : queue.waiting) {
+        for (const Waiter& waiter : call.waiters) {
+            if (waiter.id == callId) {
+                return &call;
+            }
+        }
+    }
+    for (Call& call : queue.started) {
+        for (const Waiter& waiter : call.waiters) {
+            if (waiter.id == callId) {
+                return &call;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool ModuleCallDispatcher::abandon(quint64 callId, Waiter* abandonedWaiter, bool* lastWaiter, Call* abandonedCall)
+{
+    const auto moduleIt = m_callModules.constFind(callId);
+    if (moduleIt == m_callModules.constEnd()) {
+        return false;
+    }
+    const QString module = moduleIt.value();
+    m_callModules.erase(moduleIt);
+
+    Call* call = findCall(module, callId);
+    if (!call) {
+        return false;
+    }
+    for (int i = 0; i < call->waiters.size(); ++i) {
+        if (call->waiters.at(i).id == callId) {
+            *abandonedWaiter = call->waiters.takeAt(i);
+            break;
+        }
+    }
+    *abandonedCall = *call;
+    *lastWaiter = call->waiters.isEmpty();
+    if (!*lastWaiter) {
+        return true;  // Others still want the result
+    }
+
+    if (!call->key.isEmpty()) {
+        m_inFlight.remove(call->key);
+    }
+    ModuleQueue& queue = m_queues[module];
+    for (int i = 0; i < queue.waiting.size(); ++i) {
+        if (&queue.waiting[i] == call) {
+            queue.waiting.removeAt(i);
+            return true;
+        }
+    }
+    // Started: keeps its place so the calls after it are still delivered in order
+    call->abandoned->store(true);
+    const bool released = releaseRunningCall(queue, *call);
+    deliverFinished(queue);
+    if (released) {
+        startCalls(module);
+    }
+    return true;
+}
+
+bool ModuleCallDispatcher::releaseRunningCall(ModuleQueue& queue, Call& call)
+{
+    int expected = Running;
+    if (!call.workerState->compare_exchange_strong(expected, ThreadReleased)) {
+        return false;  // Returned; onCallFinished() frees the slot
+    }
+    call.slotReleased = true;
+    --queue.running;
+    // Lets the pool run another call next to the stuck one; the worker reserves
+    // the thread again when its remote call returns
+    m_pool.releaseThread();
+    return true;
+}
+
+void ModuleCallDispatcher::startCalls(const QString& module)
+{
+    ModuleQueue& queue = m_queues[module];
+    const int limit = concurrency(module);
+    while (!queue.waiting.isEmpty() && queue.running < limit) {
+        Call call = queue.waiting.takeFirst();
+        // Nobody is left to receive the result; skip the round trip
+        if (!call.hasLiveWaiter()) {
+            for (const Waiter& waiter : call.waiters) {
+                m_callModules.remove(waiter.id);
+            }
+            if (!call.key.isEmpty()) {
+                m_inFlight.remove(call.key);
+            }
+            continue;
+        }
+        const quint64 sequence = call.sequence;
+        const QString method = call.method;
+        const QVariantList args = call.args;
+        const std::shared_ptr<std::atomic<bool>> abandoned = call.abandoned;
+        call.workerState = std::make_shared<std::atomic<int>>(Running);
+        const std::shared_ptr<std::atomic<int>> workerState = call.workerState;
+        queue.started.insert(sequence, call);
+        ++queue.running;
+
+        m_pool.start([this, invoker = m_invoker, module, sequence, method, args, abandoned, workerState]() {
+            QString error;
+            QVariant result;
+            QElapsedTimer latency;
+            latency.start();
+            if (!abandoned->load()) {
+                result = invoker(module, method, args, *abandoned, &error);
+            }
+            int expected = Running;
+            if (!workerState->compare_exchange_strong(expected, Returned)) {
+                m_pool.reserveThread();
+            }
+            const qint64 latencyMs = latency.elapsed();
+            QMetaObject::invokeMethod(this, [this, module, sequence, result, error, latencyMs]() {
+                onCallFinished(module, sequence, result, error, latencyMs);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+QVariant ModuleCallDispatcher::invokeOnWorker(const QString& module,
+                                              const QString& method,
+                                              const QVariantList& args,
+                                              const std::atomic<bool>& abandoned,
+                                              QString* error)
+{
+    if (!workerApi.hasLocalData()) {
+        workerApi.setLocalData(new LogosAPI("core"));
+    }
+    LogosAPIClient* client = workerApi.localData()->getClient(module);
+
+    // A new connection needs a moment before the first call to a module; wait for
+    // its replica to become valid, for up to 2 s or until the call is abandoned
+    QRemoteObjectReplica* replica = client && !client->isConnected()
+        ? qobject_cast<QRemoteObjectReplica*>(client->requestObject(module))
+        : nullptr;
+    if (replica && !replica->isReplicaValid()) {
+        QEventLoop loop;
+        QObject::connect(replica, &QRemoteObjectReplica::stateChanged, &loop,
+                         [&loop](QRemoteObjectReplica::State state, QRemoteObjectReplica::State) {
+            if (state == QRemoteObjectReplica::Valid) {
+                loop.quit();
+            }
+        });
+        QTimer::singleShot(2000, &loop, &QEventLoop::quit);
+        // abandoned is set from the GUI thread without a signal
+        QTimer abandonCheck;
+        QObject::connect(&abandonCheck, &QTimer::timeout, &loop, [&loop, &abandoned]() {
+            if (abandoned.load()) {
+                loop.quit();
+            }
+        });
+        abandonCheck.start(50);
+        loop.exec();
+    }
+    if (abandoned.load()) {
+        return QVariant();
+    }
+    if (!client || !client->isConnected()) {
+        *error = "Module not connected";
+        return QVariant();
+    }
+
+    const QVariant result = client->invokeRemoteMethod(module, method, args);
+    if (!result.isValid()) {
+        *error = "Invalid response";
+    }
+    return result;
+}
+
+void ModuleCallDispatcher::onCallFinished(const QString& module,
+                                          quint64 sequence,
+                                          const QVariant& result,
+                                          const QString& error,
+                                          qint64 latencyMs)
+{
+    ModuleQueue& queue = m_queues[module];
+    auto it = queue.started.find(sequence);
+    if (it == queue.started.end() || !it->slotReleased) {
+        --queue.running;
+    }
+    if (it != queue.started.end()) {
+        it->finished = true;
+        it->result = result;
+        it->error = error;
+        // Calls made from now on go to the module again
+        if (!it->key.isEmpty() && m_inFlight.value(it->key) == qMakePair(module, sequence)) {
+            m_inFlight.remove(it->key);
+        }
+        // Timed out calls were counted when they expired; cancelled ones tell nothing
+        if (m_healthMonitor && !it->probe && !it->abandoned->load()) {
+            if (error.isEmpty()) {
+                m_healthMonitor->recordSuccess(module, latencyMs);
+            } else {
+                m_healthMonitor->recordFailure(module, error, latencyMs);
+            }
+        }
+    }
+    deliverFinished(queue);
+    startCalls(module);
+    flushDeliveries();
+}
+
+void ModuleCallDispatcher::deliverFinished(ModuleQueue& queue)
+{
+    // Results that overtook an earlier call to the same module wait for it, unless
+    // that call was abandoned
+    auto it = queue.started.begin();
+    while (it != queue.started.end()) {
+        if (it->finished) {
+            if (!it->abandoned->load()) {
+                const Call call = *it;
+                for (const Waiter& waiter : call.waiters) {
+                    m_callModules.remove(waiter.id);
+                    queueDelivery(waiter, call.result, call.error);
+                }
+            }
+            it = queue.started.erase(it);
+        } else if (it->abandoned->load()) {
+            ++it;  // Still running; dropped once it returns
+        } else {
+            break;
+        }
+    }
+}
+
+void ModuleCallDispatcher::queueDelivery(const Waiter& waiter, const QVariant& result, const QString& error)
+{
+    m_deliveries.append(Delivery{waiter, result, error});
+}
+
+void ModuleCallDispatcher::flushDeliveries()
+{
+    if (m_delivering) {
+        return;
+    }
+    m_delivering = true;
+    while (!m_deliveries.isEmpty()) {
+        const Delivery delivery = m_deliveries.takeFirst();
+        deliver(delivery.waiter, delivery.result, delivery.error);
+    }
+    m_delivering = false;
+}
+
+void ModuleCallDispatcher::deliver(const Waiter& waiter, const QVariant& result, const QString& error)
+{
+    QObject* context = waiter.context.data();
+    if (!context || !waiter.callback) {
+        return;
+    }
+    const Callback callback = waiter.callback;
+    // Direct when the caller lives on this thread, queued to its thread otherwise
+    QMetaObject::invokeMethod(context, [callback, result, error]() {
+        callback(result, error);
+    }, Qt::AutoConnection);
+}
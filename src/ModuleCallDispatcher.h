@@ -0,0 +1,194 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QString>
+#include <QThreadPool>
+#include <QVariant>
+#include <QVariantList>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "ModuleCallPolicy.h"
+
+class ModuleHealthMonitor;
+
+// Runs remote calls to core modules off the GUI thread.
+//
+// Each module has its own queue. Calls to one module start in the order they were
+// made, at most concurrency(module) at a time (1 by default, so they also run one
+// after another), while calls to different modules run in parallel on a shared
+// thread pool. Every pool thread has a LogosAPI connection of its own. Results are
+// handed back on the thread of the context object passed to call(), in the order
+// the calls were made to that module.
+//
+// Every call has a deadline and can be cancelled by id or together with the other
+// calls of its context. A call that times out gets the error "Call timed out" right
+// away; a cancelled call gets nothing. Either way it is removed from its queue if it
+// has not started, and its result is dropped if it has. A remote call that is
+// already running cannot be interrupted: the LogosAPI call takes no deadline. Its
+// module slot and pool thread are given to the next calls instead, so a hung call
+// delays nobody, although the module may then see more than concurrency(module)
+// calls at once until it returns.
+//
+// A call identical to one still in flight (same module, method and arguments) joins
+// it instead of reaching the module again, and gets the same result at the same time
+// (so possibly before calls that were made earlier but run later), unless the call
+// policy (module-call-policy.json) turns singleFlight off for the method. The remote
+// call is only abandoned once every caller sharing it is gone. Only calls made through
+// the dispatcher take part; the blocking LogosQmlBridge::callModule() does not.
+//
+// With a health monitor, calls to a module it considers unhealthy fail at once with
+// "Module unavailable", the outcome and latency of every call are reported to it,
+// and its probes are run here.
+//
+// LOGOS_MODULE_CALL_THREADS sets the pool size (default 4),
+// LOGOS_MODULE_CALL_CONCURRENCY the default per-module limit and
+// LOGOS_MODULE_CALL_TIMEOUT_MS the default deadline (default 30000, 0 for none).
+class ModuleCallDispatcher : public QObject {
+    Q_OBJECT
+public:
+    // error is empty on success
+    using Callback = std::function<void(const QVariant& result, const QString& error)>;
+    // Makes one remote call on a pool thread; sets error on failure
+    using Invoker = std::function<QVariant(const QString& module,
+                                           const QString& method,
+                                           const QVariantList& args,
+                                           const std::atomic<bool>& abandoned,
+                                           QString* error)>;
+
+    explicit ModuleCallDispatcher(QObject* parent = nullptr);
+    ~ModuleCallDispatcher();
+
+    void setHealthMonitor(ModuleHealthMonitor* monitor);
+    // Replaces the LogosAPI call made for calls started from now on (tests)
+    void setInvoker(Invoker invoker);
+    ModuleCallPolicy& policy() { return m_policy; }
+    const ModuleCallPolicy& policy() const { return m_policy; }
+    void reloadPolicy();
+
+    // timeoutMs < 0 uses the default, 0 means no deadline. Returns an id for cancel(),
+    // or 0 if the call failed fast.
+    quint64 call(const QString& module,
+                 const QString& method,
+                 const QVariantList& args,
+                 QObject* context,
+                 Callback callback,
+                 int timeoutMs = -1);
+    void cancel(quint64 callId);
+    // Cancels every call whose results would go to context
+    void cancelAll(QObject* context);
+
+    void setConcurrency(const QString& module, int maxRunning);
+    int concurrency(const QString& module) const;
+    // Remote calls queued or running for module
+    int pendingCalls(const QString& module) const;
+    // Calls that joined one already in flight instead of making their own
+    quint64 sharedCalls() const { return m_sharedCalls; }
+    int defaultTimeoutMs() const { return m_defaultTimeoutMs; }
+
+    // (module, method, arguments) as one string; equal for equal arguments
+    static QString callKey(const QString& module, const QString& method, const QVariantList& args);
+
+private:
+    // A caller waiting for the result of a call
+    struct Waiter {
+        quint64 id = 0;
+        QPointer<QObject> context;
+        Callback callback;
+    };
+
+    // One remote call, shared by every waiter that asked for the same thing
+    struct Call {
+        quint64 sequence = 0;
+        QString key;  // empty when the call may not be shared
+        QString method;
+        QVariantList args;
+        QList<Waiter> waiters;
+        // Shared with the worker, which skips calls abandoned before it got to them
+        std::shared_ptr<std::atomic<bool>> abandoned;
+        // Shared with the worker; see WorkerState
+        std::shared_ptr<std::atomic<int>> workerState;
+        bool slotReleased = false;  // abandoned while running; no longer counted in running
+        bool probe = false;
+        bool finished = false;
+        QVariant result;
+        QString error;
+
+        bool hasLiveWaiter() const;
+    };
+
+    // Whoever moves a started call out of Running first decides who balances the pool:
+    // the dispatcher releases the call's thread when it abandons the call, and the
+    // worker reserves one again when the remote call finally returns
+    enum WorkerState {
+        Running,
+        ThreadReleased,
+        Returned
+    };
+
+    // A result ready for a waiter, handed over once the queues are consistent again
+    struct Delivery {
+        Waiter waiter;
+        QVariant result;
+        QString error;
+    };
+
+    struct ModuleQueue {
+        QList<Call> waiting;
+        QMap<quint64, Call> started;  // by sequence, until delivered in order
+        int running = 0;
+        int maxRunning = 0;  // 0: the default
+        quint64 nextSequence = 0;
+    };
+
+    quint64 enqueue(const QString& module, Call call, Waiter waiter, int timeoutMs);
+    Call* findCall(const QString& module, quint64 callId);
+    void runProbe(const QString& module);
+    void startCalls(const QString& module);
+    // Gives an abandoned running call's slot and pool thread to the calls after it;
+    // false if the call had already returned
+    bool releaseRunningCall(ModuleQueue& queue, Call& call);
+    void onCallFinished(const QString& module,
+                        quint64 sequence,
+                        const QVariant& result,
+                        const QString& error,
+                        qint64 latencyMs);
+    void deliverFinished(ModuleQueue& queue);
+    // Removes the waiter from its call. A call without waiters is taken out of its
+    // queue, or marked abandoned if it has started; lastWaiter tells whether that
+    // happened. False if the waiter was already served.
+    bool abandon(quint64 callId, Waiter* waiter, bool* lastWaiter, Call* call);
+    void expire(quint64 callId);
+    // Callbacks may call back into the dispatcher, so they only run from
+    // flushDeliveries(), at the end of each entry point, never while a queue is
+    // being walked. Nested flushes leave the work to the outer one, which keeps the
+    // order.
+    void queueDelivery(const Waiter& waiter, const QVariant& result, const QString& error);
+    void flushDeliveries();
+    static void deliver(const Waiter& waiter, const QVariant& result, const QString& error);
+    static QVariant invokeOnWorker(const QString& module,
+                                   const QString& method,
+                                   const QVariantList& args,
+                                   const std::atomic<bool>& abandoned,
+                                   QString* error);
+
+    QPointer<ModuleHealthMonitor> m_healthMonitor;
+    ModuleCallPolicy m_policy;
+    QHash<QString, ModuleQueue> m_queues;
+    QHash<quint64, QString> m_callModules;  // id of every waiter not yet served -> module
+    QHash<QString, QPair<QString, quint64>> m_inFlight;  // call key -> module and sequence
+    QList<Delivery> m_deliveries;
+    bool m_delivering;
+    Invoker m_invoker;
+    quint64 m_nextCallId;
+    quint64 m_sharedCalls;
+    int m_defaultConcurrency;
+    int m_defaultTimeoutMs;
+    QThreadPool m_pool;
+};
@@ -0,0 +1,92 @@
+#include "ModuleCallPolicy.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QStandardPaths>
+
+QString ModuleCallPolicy::path()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/module-call-policy.json";
+}
+
+void ModuleCallPolicy::load()
+{
+    QFile file(path());
+    if (!file.open(QIODevice::ReadOnly)) {
+        load(QJsonObject());
+        return;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "ModuleCallPolicy: ignoring" << path() << ":" << parseError.errorString();
+        load(QJsonObject());
+        return;
+    }
+    qDebug() << "ModuleCallPolicy: loaded" << path();
+    load(doc.object());
+}
+
+void ModuleCallPolicy::load(const QJsonObject& policy)
+{
+    m_policy = policy;
+}
+
+void ModuleCallPolicy::setModuleDefaults(const QString& module, const QJsonObject& defaults)
+{
+    m_moduleDefaults.insert(module, defaults);
+}
+
+QJsonValue ModuleCallPolicy::option(const QString& module, const QString& method, const QString& key) const
+{
+    const QJsonObject sources[] = {m_policy.value(module).toObject(), m_moduleDefaults.value(module)};
+    for (const QJsonObject& moduleOptions : sources) {
+        const QJsonObject methodOptions = moduleOptions.value(method).toObject();
+        if (methodOptions.contains(key)) {
+            return methodOptions.value(key);
+        }
+        const QJsonObject anyMethod = moduleOptions.value("*").toObject();
+        if (anyMethod.contains(key)) {
+            return anyMethod.value(key);
+        }
+    }
+    return QJsonValue();
+}
+
+bool ModuleCallPolicy::singleFlight(const QString& module, const QString& method) const
+{
+    return option(module, method, "singleFlight").toBool(true);
+}
+
+int ModuleCallPolicy::cacheTtlMs(const QString& module, const QString& method) const
+{
+    return qMax(0, option(module, method, "cacheTtlMs").toInt(0));
+}
+
+QStringList ModuleCallPolicy::invalidatedBy(const QString& module, const QString& method) const
+{
+    QStringList events;
+    for (const QJsonValue& event : option(module, method, "invalidatedBy").toArray()) {
+        events << event.toString();
+    }
+    return events;
+}
+
+QStringList ModuleCallPolicy::invalidatingEvents(const QString& module) const
+{
+    QStringList events;
+    const QJsonObject sources[] = {m_policy.value(module).toObject(), m_moduleDefaults.value(module)};
+    for (const QJsonObject& moduleOptions : sources) {
+        for (auto it = moduleOptions.constBegin(); it != moduleOptions.constEnd(); ++it) {
+            for (const QJsonValue& event : it.value().toObject().value("invalidatedBy").toArray()) {
+                if (!events.contains(event.toString())) {
+                    events << event.toString();
+                }
+            }
+        }
+    }
+    return events;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+// Per-method options for calls to core modules, read from
+// <AppConfigLocation>/module-call-policy.json:
+//
+//   {
+//     "wallet": {
+//       "send": { "singleFlight": false },
+//       "getBalance": { "cacheTtlMs": 5000, "invalidatedBy": ["balanceChanged"] },
+//       "*": { ... }                        // every other wallet method
+//     }
+//   }
+//
+// singleFlight (default true): identical calls (same module, method and arguments)
+// made through the call dispatcher while one is in flight share its result. Turn it
+// off for methods with side effects, where every call has to reach the module.
+//
+// cacheTtlMs (default 0, off): results are reused for this long (see
+// ModuleResultCache); invalidatedBy lists module events that drop them earlier.
+//
+// A module can ship the same object for its own methods as "callPolicy" in its
+// plugin metadata. The file wins over the metadata, option by option.
+class ModuleCallPolicy {
+public:
+    static QString path();
+
+    // Reads path(); a missing file leaves the defaults
+    void load();
+    void load(const QJsonObject& policy);
+    // The module's "callPolicy" metadata
+    void setModuleDefaults(const QString& module, const QJsonObject& defaults);
+
+    bool singleFlight(const QString& module, const QString& method) const;
+    int cacheTtlMs(const QString& module, const QString& method) const;
+    QStringList invalidatedBy(const QString& module, const QString& method) const;
+    // Every event that invalidates a cached method of module
+    QStringList invalidatingEvents(const QString& module) const;
+
+private:
+    // The first of: the method's entry in the file, the module's "*" in the file,
+    // the method's entry in the metadata, the module's "*" in the metadata
+    QJsonValue option(const QString& module, const QString& method, const QString& key) const;
+
+    QJsonObject m_policy;
+    QHash<QString, QJsonObject> m_moduleDefaults;
+};
@@ -0,0 +1,79 @@
+#include "ModuleClientRegistry.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRemoteObjectReplica>
+
+#include "logos_api.h"
+#include "logos_api_client.h"
+
+ModuleClientRegistry::ModuleClientRegistry(LogosAPI* logosAPI, QObject* parent)
+    : QObject(parent)
+    , m_logosAPI(logosAPI)
+{
+}
+
+ModuleClientRegistry::Entry& ModuleClientRegistry::entry(const QString& module)
+{
+    Entry& entry = m_entries[module];
+    if (!entry.client && m_logosAPI) {
+        entry.client = m_logosAPI->getClient(module);
+    }
+    return entry;
+}
+
+LogosAPIClient* ModuleClientRegistry::client(const QString& module)
+{
+    return entry(module).client;
+}
+
+bool ModuleClientRegistry::isConnected(const QString& module)
+{
+    const Entry& moduleEntry = entry(module);
+    // The replica belongs to the client; once it is gone, ask the client again
+    if (moduleEntry.replica) {
+        return moduleEntry.connected;
+    }
+    return moduleEntry.client && moduleEntry.client->isConnected();
+}
+
+void ModuleClientRegistry::warmUp(const QString& module)
+{
+    Entry& moduleEntry = entry(module);
+    if (!moduleEntry.client || moduleEntry.replica) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QRemoteObjectReplica* replica = qobject_cast<QRemoteObjectReplica*>(moduleEntry.client->requestObject(module));
+    if (!replica) {
+        qDebug() << "ModuleClientRegistry:" << module << "connection is checked on use";
+        return;
+    }
+    moduleEntry.replica = replica;
+    connect(replica, &QRemoteObjectReplica::stateChanged, this,
+            [this, module](QRemoteObjectReplica::State state, QRemoteObjectReplica::State) {
+        setConnected(module, state == QRemoteObjectReplica::Valid);
+    });
+    setConnected(module, replica->isReplicaValid());
+    qDebug() << "ModuleClientRegistry: warmed up" << module << "in" << timer.elapsed() << "ms";
+}
+
+void ModuleClientRegistry::forget(const QString& module)
+{
+    const Entry moduleEntry = m_entries.take(module);
+    if (moduleEntry.replica) {
+        disconnect(moduleEntry.replica, nullptr, this, nullptr);
+    }
+}
+
+void ModuleClientRegistry::setConnected(const QString& module, bool connected)
+{
+    auto it = m_entries.find(module);
+    if (it == m_entries.end() || it->connected == connected) {
+        return;
+    }
+    it->connected = connected;
+    emit connectionChanged(module, connected);
+}
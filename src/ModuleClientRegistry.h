@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+class LogosAPI;
+class LogosAPIClient;
+class QRemoteObjectReplica;
+
+// Resolved core module clients and their connection state, for the GUI thread.
+//
+// Call sites used to resolve getClient(module) and ask isConnected() on every
+// call, and the first call to a module paid for setting up its connection. Here a
+// module's client is resolved once and kept until the module is unloaded.
+// warmUp() runs when a module has been loaded. It requests the module's replica
+// ahead of the first call and then follows the replica's stateChanged signal, so
+// isConnected() is answered from the last reported state. Modules that were not
+// warmed up, or whose replica is not a QRemoteObjectReplica, fall back to
+// asking the client.
+class ModuleClientRegistry : public QObject {
+    Q_OBJECT
+public:
+    explicit ModuleClientRegistry(LogosAPI* logosAPI, QObject* parent = nullptr);
+
+    // nullptr without LogosAPI
+    LogosAPIClient* client(const QString& module);
+    bool isConnected(const QString& module);
+
+    // module has just been loaded; connects to it before its first call
+    void warmUp(const QString& module);
+    // module was unloaded; its next client is resolved again
+    void forget(const QString& module);
+
+signals:
+    void connectionChanged(const QString& module, bool connected);
+
+private:
+    struct Entry {
+        LogosAPIClient* client = nullptr;
+        QPointer<QRemoteObjectReplica> replica;
+        bool connected = false;
+    };
+
+    Entry& entry(const QString& module);
+    void setConnected(const QString& module, bool connected);
+
+    LogosAPI* m_logosAPI;
+    QHash<QString, Entry> m_entries;
+};
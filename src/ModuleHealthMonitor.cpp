@@ -0,0 +1,159 @@
+#include "ModuleHealthMonitor.h"
+
+#include <QDebug>
+#include <QTimer>
+
+namespace {
+
+const int kWindowSize = 20;
+const int kMinimumWindow = 10;
+const int kMaxConsecutiveFailures = 5;
+const int kFirstProbeDelayMs = 5000;
+const int kMaxProbeDelayMs = 60000;
+
+}
+
+ModuleHealthMonitor::ModuleHealthMonitor(QObject* parent)
+    : QObject(parent)
+    , m_firstProbeDelayMs(kFirstProbeDelayMs)
+{
+}
+
+QString ModuleHealthMonitor::stateName(State state)
+{
+    switch (state) {
+    case State::Healthy:
+        return "healthy";
+    case State::Unhealthy:
+        return "unhealthy";
+    case State::Probing:
+        return "probing";
+    }
+    return QString();
+}
+
+bool ModuleHealthMonitor::allowCall(const QString& module, QString* reason) const
+{
+    const auto it = m_health.constFind(module);
+    if (it == m_health.constEnd() || it->state == State::Healthy) {
+        return true;
+    }
+    if (reason) {
+        *reason = it->lastError.isEmpty() ? QString("Module unavailable")
+                                          : QString("Module unavailable: %1").arg(it->lastError);
+    }
+    return false;
+}
+
+void ModuleHealthMonitor::recordSuccess(const QString& module, qint64 latencyMs)
+{
+    record(module, false, QString(), latencyMs);
+}
+
+void ModuleHealthMonitor::recordFailure(const QString& module, const QString& error, qint64 latencyMs)
+{
+    record(module, true, error, latencyMs);
+}
+
+void ModuleHealthMonitor::record(const QString& module, bool failed, const QString& error, qint64 latencyMs)
+{
+    Health& health = m_health[module];
+    // Calls that were already running when the circuit opened say nothing new
+    if (health.state != State::Healthy) {
+        return;
+    }
+
+    health.recent.append(failed);
+    if (health.recent.size() > kWindowSize) {
+        health.recent.removeFirst();
+    }
+    if (failed) {
+        ++health.consecutiveFailures;
+        health.lastError = error;
+        health.connected = error != "Module not connected";
+    } else {
+        health.consecutiveFailures = 0;
+        health.connected = true;
+        health.latencyMs = health.latencyMs < 0 ? latencyMs : 0.8 * health.latencyMs + 0.2 * latencyMs;
+    }
+
+    const int failures = health.recent.count(true);
+    if (health.consecutiveFailures >= kMaxConsecutiveFailures
+        || (health.recent.size() >= kMinimumWindow && failures * 2 >= health.recent.size())) {
+        trip(module, health);
+    }
+}
+
+void ModuleHealthMonitor::trip(const QString& module, Health& health)
+{
+    qWarning() << "ModuleHealthMonitor:" << module << "is unhealthy (" << health.lastError
+               << "); failing calls to it until a probe succeeds";
+    health.state = State::Unhealthy;
+    health.unhealthySince.start();
+    health.probeDelayMs = m_firstProbeDelayMs;
+    scheduleProbe(module, health);
+    emit healthChanged(module);
+}
+
+void ModuleHealthMonitor::scheduleProbe(const QString& module, Health& health)
+{
+    QTimer::singleShot(health.probeDelayMs, this, [this, module]() { probe(module); });
+}
+
+void ModuleHealthMonitor::probe(const QString& module)
+{
+    auto it = m_health.find(module);
+    if (it == m_health.end() || it->state != State::Unhealthy) {
+        return;  // Forgotten in the meantime
+    }
+    it->state = State::Probing;
+    emit healthChanged(module);
+    emit probeRequested(module);
+}
+
+void ModuleHealthMonitor::recordProbe(const QString& module, bool success, const QString& error)
+{
+    auto it = m_health.find(module);
+    if (it == m_health.end() || it->state != State::Probing) {
+        return;
+    }
+
+    if (success) {
+        qInfo() << "ModuleHealthMonitor:" << module << "is healthy again after"
+                << it->unhealthySince.elapsed() / 1000 << "s";
+        const double latencyMs = it->latencyMs;
+        *it = Health();
+        it->latencyMs = latencyMs;
+    } else {
+        it->state = State::Unhealthy;
+        it->lastError = error;
+        it->connected = error != "Module not connected";
+        it->probeDelayMs = qMin(qMax(it->probeDelayMs * 2, 1), kMaxProbeDelayMs);
+        scheduleProbe(module, *it);
+    }
+    emit healthChanged(module);
+}
+
+void ModuleHealthMonitor::forget(const QString& module)
+{
+    if (m_health.remove(module) > 0) {
+        emit healthChanged(module);
+    }
+}
+
+ModuleHealthMonitor::State ModuleHealthMonitor::state(const QString& module) const
+{
+    return m_health.value(module).state;
+}
+
+QVariantMap ModuleHealthMonitor::health(const QString& module) const
+{
+    const Health health = m_health.value(module);
+    QVariantMap result;
+    result["state"] = stateName(health.state);
+    result["latencyMs"] = health.latencyMs < 0 ? QVariant() : QVariant(qRound(health.latencyMs));
+    result["errorRate"] = health.recent.isEmpty() ? 0.0 : double(health.recent.count(true)) / health.recent.size();
+    result["connected"] = health.connected;
+    result["lastError"] = health.lastError;
+    return result;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+
+// Tracks the health of each core module from the outcome of calls to it, and
+// breaks the circuit to modules that keep failing.
+//
+// A call fails when the module is not connected, times out or gives no valid
+// response. After 5 failures in a row, or when at least half of the last 20 calls
+// failed, the module is marked unhealthy: calls to it fail at once with
+// "Module unavailable" instead of waiting out the failure again. In the background
+// the module is then probed (probeRequested), first after 5 s and then with the
+// interval doubling up to a minute; the first successful probe makes it healthy again.
+class ModuleHealthMonitor : public QObject {
+    Q_OBJECT
+public:
+    enum class State {
+        Healthy,
+        Unhealthy,  // calls fail fast until a probe succeeds
+        Probing,
+    };
+
+    explicit ModuleHealthMonitor(QObject* parent = nullptr);
+
+    // Delay before the first probe of a tripped module; doubles on each failed probe
+    void setFirstProbeDelay(int ms) { m_firstProbeDelayMs = ms; }
+
+    // False while the circuit is open; reason then says why
+    bool allowCall(const QString& module, QString* reason = nullptr) const;
+    void recordSuccess(const QString& module, qint64 latencyMs);
+    void recordFailure(const QString& module, const QString& error, qint64 latencyMs);
+    // Outcome of a call started after probeRequested()
+    void recordProbe(const QString& module, bool success, const QString& error);
+    // Loaded or unloaded: start over
+    void forget(const QString& module);
+
+    State state(const QString& module) const;
+    // state, latencyMs, errorRate, connected and lastError, for the Modules view
+    QVariantMap health(const QString& module) const;
+    static QString stateName(State state);
+
+signals:
+    void healthChanged(const QString& module);
+    void probeRequested(const QString& module);
+
+private:
+    struct Health {
+        State state = State::Healthy;
+        QList<bool> recent;  // last outcomes, true for failures
+        int consecutiveFailures = 0;
+        double latencyMs = -1;  // moving average, -1 before the first answer
+        bool connected = true;
+        QString lastError;
+        int probeDelayMs = 0;
+        QElapsedTimer unhealthySince;
+    };
+
+    void record(const QString& module, bool failed, const QString& error, qint64 latencyMs);
+    void trip(const QString& module, Health& health);
+    void scheduleProbe(const QString& module, Health& health);
+    void probe(const QString& module);
+
+    QHash<QString, Health> m_health;
+    int m_firstProbeDelayMs;
+};
@@ -0,0 +1,232 @@
+#include "ModuleLazyLoader.h"
+#include "ModuleLeaseManager.h"
+#include "ModuleClientRegistry.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QThreadStorage>
+#include <QTimer>
+
+#include "logos_api.h"
+#include "logos_api_client.h"
+#include "logos_sdk.h"
+
+namespace {
+
+// Connecting to the core costs more than a load request, so a loader thread reuses
+// its connection for later loads; it is deleted when the pool retires the thread
+QThreadStorage<LogosAPI*> loaderApi;
+
+}
+
+ModuleLazyLoader::ModuleLazyLoader(LogosAPI* logosAPI,
+                                   ModuleLeaseManager* leases,
+                                   ModuleClientRegistry* clients,
+                                   QObject* parent)
+    : QObject(parent)
+    , m_logosAPI(logosAPI)
+    , m_leases(leases)
+    , m_clients(clients)
+    , m_enabled(isEnabledFromEnvironment())
+    , m_timeoutMs(timeoutFromEnvironment())
+    , m_loader(&ModuleLazyLoader::loadWithCoreManager)
+    , m_pollTimer(new QTimer(this))
+{
+    m_pool.setMaxThreadCount(2);
+    m_pollTimer->setInterval(100);
+    connect(m_pollTimer, &QTimer::timeout, this, &ModuleLazyLoader::poll);
+    connect(m_clients, &ModuleClientRegistry::connectionChanged, this, &ModuleLazyLoader::onConnectionChanged);
+}
+
+ModuleLazyLoader::~ModuleLazyLoader()
+{
+    // Loads report back to this object; never let them outlive it
+    m_pool.waitForDone();
+}
+
+bool ModuleLazyLoader::isEnabledFromEnvironment()
+{
+    return qEnvironmentVariableIntValue("LOGOS_LAZY_MODULE_LOADING") == 1;
+}
+
+int ModuleLazyLoader::timeoutFromEnvironment()
+{
+    bool ok = false;
+    const int timeoutMs = qEnvironmentVariableIntValue("LOGOS_MODULE_LOAD_TIMEOUT_MS", &ok);
+    return ok && timeoutMs > 0 ? timeoutMs : 15000;
+}
+
+void ModuleLazyLoader::setLoader(Loader loader)
+{
+    m_loader = loader ? std::move(loader) : Loader(&ModuleLazyLoader::loadWithCoreManager);
+}
+
+bool ModuleLazyLoader::loadWithCoreManager(const QString& module)
+{
+    if (!loaderApi.hasLocalData()) {
+        loaderApi.setLocalData(new LogosAPI("core"));
+    }
+    LogosModules logos(loaderApi.localData());
+    return logos.core_manager.loadPlugin(module);
+}
+
+void ModuleLazyLoader::refreshKnownModules()
+{
+    if (!m_logosAPI) {
+        return;
+    }
+    if (!m_clients->isConnected("core_manager")) {
+        return;
+    }
+    LogosModules logos(m_logosAPI);
+    m_knownModules.clear();
+    for (const QJsonValue& val : logos.core_manager.getKnownPlugins()) {
+        m_knownModules.insert(val.toObject()["name"].toString());
+    }
+    m_knownModulesRefresh.setRemainingTime(5000);
+}
+
+bool ModuleLazyLoader::isKnown(const QString& module)
+{
+    // Modules installed since the last refresh are picked up, at most every few seconds
+    if (!m_knownModules.contains(module) && m_knownModulesRefresh.hasExpired()) {
+        refreshKnownModules();
+    }
+    return m_knownModules.contains(module);
+}
+
+void ModuleLazyLoader::request(const QString& module, const QString& holder)
+{
+    auto it = m_pending.find(module);
+    if (it != m_pending.end()) {
+        if (it->timedOut) {
+            // The earlier load is still running; wait for it instead of starting another
+            it->timedOut = false;
+            it->deadline.setRemainingTime(m_timeoutMs);
+            m_pollTimer->start();
+        }
+        if (!it->holders.contains(holder)) {
+            it->holders << holder;
+        }
+        return;
+    }
+
+    PendingLoad load;
+    load.holders << holder;
+    load.deadline.setRemainingTime(m_timeoutMs);
+    m_pending.insert(module, load);
+    m_pollTimer->start();
+
+    qDebug() << "ModuleLazyLoader: loading" << module << "on first use by" << holder;
+    m_pool.start([this, loader = m_loader, module]() {
+        const bool success = loader(module);
+        QMetaObject::invokeMethod(this, [this, module, success]() {
+            onLoadFinished(module, success);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ModuleLazyLoader::dropHolder(const QString& holder)
+{
+    for (PendingLoad& load : m_pending) {
+        load.holders.removeAll(holder);
+    }
+}
+
+void ModuleLazyLoader::onLoadFinished(const QString& module, bool success)
+{
+    auto it = m_pending.find(module);
+    if (it == m_pending.end()) {
+        return;
+    }
+    if (it->timedOut) {
+        m_pending.erase(it);
+        if (success) {
+            qDebug() << "ModuleLazyLoader:" << module << "loaded after its callers timed out";
+            m_knownModules.insert(module);
+            leaseOrphan(module);
+        }
+        return;
+    }
+    if (!success) {
+        finish(module, "Module failed to load");
+        return;
+    }
+    it->loaded = true;
+    // Finishes through onConnectionChanged() once connected; poll() handles the rest
+    m_clients->warmUp(module);
+    poll();
+}
+
+void ModuleLazyLoader::onConnectionChanged(const QString& module, bool connected)
+{
+    auto it = m_pending.find(module);
+    if (connected && it != m_pending.end() && it->loaded) {
+        finish(module, QString());
+    }
+}
+
+void ModuleLazyLoader::poll()
+{
+    bool waiting = false;
+    const QStringList modules = m_pending.keys();
+    for (const QString& module : modules) {
+        PendingLoad& load = m_pending[module];
+        if (load.timedOut) {
+            continue;  // Only the worker's answer is left
+        }
+        if (load.loaded && m_clients->isConnected(module)) {
+            finish(module, QString());
+            continue;
+        }
+        if (!load.deadline.hasExpired()) {
+            waiting = true;
+        } else if (load.loaded) {
+            // Loaded but never connected; nobody will release it otherwise
+            finish(module, "Module load timed out");
+            leaseOrphan(module);
+        } else {
+            load.timedOut = true;
+            load.holders.clear();
+            qWarning() << "ModuleLazyLoader:" << module << ": Module load timed out";
+            emit moduleFailed(module, "Module load timed out");
+        }
+    }
+    if (!waiting) {
+        m_pollTimer->stop();
+    }
+}
+
+void ModuleLazyLoader::finish(const QString& module, const QString& error)
+{
+    const PendingLoad load = m_pending.take(module);
+    if (!error.isEmpty()) {
+        qWarning() << "ModuleLazyLoader:" << module << ":" << error;
+        emit moduleFailed(module, error);
+        return;
+    }
+
+    qDebug() << "ModuleLazyLoader:" << module << "is ready";
+    m_knownModules.insert(module);
+    if (m_leases) {
+        for (const QString& holder : load.holders) {
+            m_leases->acquire(holder, QStringList{module}, QSet<QString>());
+        }
+        if (load.holders.isEmpty()) {
+            // Everyone who asked is gone; let the grace period unload it again
+            leaseOrphan(module);
+        }
+    }
+    emit moduleReady(module);
+}
+
+void ModuleLazyLoader::leaseOrphan(const QString& module)
+{
+    if (!m_leases) {
+        return;
+    }
+    const QString orphan = "lazy:" + module;
+    m_leases->acquire(orphan, QStringList{module}, QSet<QString>());
+    m_leases->release(orphan);
+}
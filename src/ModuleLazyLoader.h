@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <functional>
+
+class LogosAPI;
+class ModuleClientRegistry;
+class ModuleLeaseManager;
+class QTimer;
+
+// Loads known core modules on first use from QML plugins.
+//
+// With LOGOS_LAZY_MODULE_LOADING=1, a bridge call to a module that the core knows
+// about but has not loaded asks this class to load it. The load runs on a worker
+// thread (core_manager.loadPlugin blocks until the module's host is up), then the
+// module is warmed up in ModuleClientRegistry and is ready once the registry reports
+// it connected (checked again every 100 ms for clients whose state is not signalled).
+// moduleReady/moduleFailed report the outcome; a load that has not connected within
+// the timeout fails. Its loadPlugin is still waited for and never started twice; if
+// it succeeds late, the module is leased to nobody so the grace period unloads it.
+// Modules loaded here are leased to the plugins that asked for them (see
+// ModuleLeaseManager), so they are unloaded again once those plugins are closed.
+class ModuleLazyLoader : public QObject {
+    Q_OBJECT
+public:
+    // Loads one module on a worker thread and returns whether it loaded
+    using Loader = std::function<bool(const QString& module)>;
+
+    ModuleLazyLoader(LogosAPI* logosAPI,
+                     ModuleLeaseManager* leases,
+                     ModuleClientRegistry* clients,
+                     QObject* parent = nullptr);
+    ~ModuleLazyLoader();
+
+    // LOGOS_LAZY_MODULE_LOADING=1
+    static bool isEnabledFromEnvironment();
+    // LOGOS_MODULE_LOAD_TIMEOUT_MS, defaults to 15000
+    static int timeoutFromEnvironment();
+
+    bool isEnabled() const { return m_enabled; }
+    void setTimeout(int ms) { m_timeoutMs = ms; }
+    // Replaces core_manager.loadPlugin for loads started from now on (tests)
+    void setLoader(Loader loader);
+    bool isKnown(const QString& module);
+    bool isLoading(const QString& module) const { return m_pending.contains(module); }
+
+    // Starts loading module for holder (a UI plugin name) unless it is already loading
+    void request(const QString& module, const QString& holder);
+    // The plugin was closed; loads it started no longer lease the module to it
+    void dropHolder(const QString& holder);
+
+signals:
+    void moduleReady(const QString& module);
+    void moduleFailed(const QString& module, const QString& error);
+
+private:
+    struct PendingLoad {
+        QStringList holders;
+        QDeadlineTimer deadline;
+        bool loaded = false;
+        // Callers were failed, but loadPlugin has not returned yet; kept so the
+        // module is not loaded twice and a late success is still leased
+        bool timedOut = false;
+    };
+
+    void refreshKnownModules();
+    void onLoadFinished(const QString& module, bool success);
+    void poll();
+    void onConnectionChanged(const QString& module, bool connected);
+    void finish(const QString& module, const QString& error);
+    // Nobody holds module any more; leases it briefly so the grace period unloads it
+    void leaseOrphan(const QString& module);
+    static bool loadWithCoreManager(const QString& module);
+
+    LogosAPI* m_logosAPI;
+    ModuleLeaseManager* m_leases;
+    ModuleClientRegistry* m_clients;
+    bool m_enabled;
+    int m_timeoutMs;
+    Loader m_loader;
+    QSet<QString> m_knownModules;
+    QDeadlineTimer m_knownModulesRefresh;
+    QHash<QString, PendingLoad> m_pending;
+    QTimer* m_pollTimer;
+    QThreadPool m_pool;
+};
@@ -0,0 +1,109 @@
+#include "ModuleLeaseManager.h"
+
+#include <QDebug>
+#include <QTimer>
+
+ModuleLeaseManager::ModuleLeaseManager(QObject* parent)
+    : QObject(parent)
+    , m_graceSeconds(graceSecondsFromEnvironment())
+{
+}
+
+int ModuleLeaseManager::graceSecondsFromEnvironment()
+{
+    bool ok = false;
+    const int seconds = qEnvironmentVariableIntValue("LOGOS_MODULE_UNLOAD_GRACE_SECONDS", &ok);
+    return ok ? seconds : 120;
+}
+
+void ModuleLeaseManager::acquire(const QString& holder, const QStringList& modules,
+                                 const QSet<QString>& alreadyLoaded)
+{
+    QStringList& held = m_leases[holder];
+    for (const QString& module : modules) {
+        if (module.isEmpty() || held.contains(module)) {
+            continue;
+        }
+        // Someone else started it; it is not ours to unload. Modules we leased before
+        // stay ours while their grace period runs, so a quick reopen does not pin them.
+        if (!m_managed.contains(module) && alreadyLoaded.contains(module)) {
+            m_pinned.insert(module);
+        } else {
+            m_managed.insert(module);
+        }
+        cancelUnload(module);
+        ++m_counts[module];
+        held << module;
+    }
+    if (held.isEmpty()) {
+        m_leases.remove(holder);
+        return;
+    }
+    qDebug() << "ModuleLeaseManager:" << holder << "holds" << held;
+}
+
+void ModuleLeaseManager::release(const QString& holder)
+{
+    const QStringList held = m_leases.take(holder);
+    for (const QString& module : held) {
+        if (--m_counts[module] > 0) {
+            continue;
+        }
+        m_counts.remove(module);
+        if (!m_pinned.contains(module)) {
+            scheduleUnload(module);
+        }
+    }
+}
+
+void ModuleLeaseManager::pin(const QString& module)
+{
+    m_pinned.insert(module);
+    cancelUnload(module);
+}
+
+void ModuleLeaseManager::forget(const QString& module)
+{
+    cancelUnload(module);
+    m_pinned.remove(module);
+    m_managed.remove(module);
+    m_counts.remove(module);
+    for (QStringList& held : m_leases) {
+        held.removeAll(module);
+    }
+}
+
+int ModuleLeaseManager::leaseCount(const QString& module) const
+{
+    return m_counts.value(module);
+}
+
+void ModuleLeaseManager::scheduleUnload(const QString& module)
+{
+    if (m_graceSeconds < 0 || m_unloadTimers.contains(module)) {
+        return;
+    }
+    qDebug() << "ModuleLeaseManager: core module" << module << "is unused, unloading in" << m_graceSeconds << "s";
+
+    QTimer* timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::VeryCoarseTimer);
+    connect(timer, &QTimer::timeout, this, [this, module]() {
+        if (QTimer* expired = m_unloadTimers.take(module)) {
+            expired->deleteLater();
+        }
+        if (m_counts.value(module) == 0 && !m_pinned.contains(module)) {
+            emit unloadRequested(module);
+        }
+    });
+    m_unloadTimers.insert(module, timer);
+    timer->start(m_graceSeconds * 1000);
+}
+
+void ModuleLeaseManager::cancelUnload(const QString& module)
+{
+    if (QTimer* timer = m_unloadTimers.take(module)) {
+        timer->stop();
+        timer->deleteLater();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class QTimer;
+
+// Reference counts on the core modules that UI apps depend on.
+//
+// A UI app holds a lease on each core module listed in its "dependencies" while it
+// is open. When the last lease on a module is released, the module is unloaded
+// after a grace period, so closing and reopening an app quickly does not restart
+// its modules. Modules that were loaded by hand, or that were already running when
+// the first lease was taken (startup, preload, another client), are pinned and
+// never unloaded here.
+class ModuleLeaseManager : public QObject {
+    Q_OBJECT
+public:
+    explicit ModuleLeaseManager(QObject* parent = nullptr);
+
+    // LOGOS_MODULE_UNLOAD_GRACE_SECONDS, defaults to 120 (negative keeps modules loaded)
+    static int graceSecondsFromEnvironment();
+    void setGracePeriod(int seconds) { m_graceSeconds = seconds; }
+
+    // Adds leases for holder. alreadyLoaded: core modules running before this call;
+    // untracked ones among them are pinned
+    void acquire(const QString& holder, const QStringList& modules, const QSet<QString>& alreadyLoaded);
+    void release(const QString& holder);
+
+    void pin(const QString& module);
+    // The module was unloaded from outside; stop tracking it
+    void forget(const QString& module);
+
+    bool isPinned(const QString& module) const { return m_pinned.contains(module); }
+    int leaseCount(const QString& module) const;
+    bool isUnloadPending(const QString& module) const { return m_unloadTimers.contains(module); }
+
+signals:
+    // Emitted when the grace period of an unreferenced, unpinned module has passed
+    void unloadRequested(const QString& module);
+
+private:
+    void scheduleUnload(const QString& module);
+    void cancelUnload(const QString& module);
+
+    int m_graceSeconds;
+    QHash<QString, QStringList> m_leases;  // holder -> modules
+    QHash<QString, int> m_counts;          // module -> leases
+    QSet<QString> m_pinned;
+    QSet<QString> m_managed;  // leased here and not pinned, until unloaded (forget)
+    QHash<QString, QTimer*> m_unloadTimers;
+};
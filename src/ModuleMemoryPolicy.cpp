@@ -0,0 +1,228 @@
+#include "ModuleMemoryPolicy.h"
+#include "ModuleLeaseManager.h"
+#include "LogosSettings.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+
+// Needed to install and update everything else
+const QStringList kAlwaysPinned = {"package_manager", "core_manager"};
+
+}
+
+ModuleMemoryPolicy::ModuleMemoryPolicy(ModuleLeaseManager* leases, QObject* parent)
+    : QObject(parent)
+    , m_leases(leases)
+    , m_timer(new QTimer(this))
+    , m_enabled(false)
+    , m_budgetMb(0)
+    , m_pressureThreshold(0)
+    , m_idleSeconds(300)
+{
+    m_timer->setTimerType(Qt::VeryCoarseTimer);
+    connect(m_timer, &QTimer::timeout, this, &ModuleMemoryPolicy::evaluate);
+    loadSettings();
+}
+
+void ModuleMemoryPolicy::loadSettings()
+{
+    auto settings = LogosSettings::open();
+    settings->beginGroup("memoryPolicy");
+    m_enabled = settings->value("enabled", false).toBool();
+    m_budgetMb = settings->value("budgetMb", 0).toDouble();
+    m_pressureThreshold = settings->value("pressureThreshold", 10).toDouble();
+    m_idleSeconds = qMax(0, settings->value("idleSeconds", 300).toInt());
+    const int intervalSeconds = qMax(1, settings->value("intervalSeconds", 10).toInt());
+    m_pinned.clear();
+    for (const QString& module : settings->value("pinned").toStringList() + kAlwaysPinned) {
+        if (!module.trimmed().isEmpty()) {
+            m_pinned.insert(module.trimmed());
+        }
+    }
+    settings->endGroup();
+
+    if (m_enabled) {
+        qDebug() << "ModuleMemoryPolicy: budget" << m_budgetMb << "MB, pressure threshold" << m_pressureThreshold
+                 << "%, idle after" << m_idleSeconds << "s, pinned" << m_pinned.values();
+        m_timer->start(intervalSeconds * 1000);
+    } else {
+        m_timer->stop();
+    }
+}
+
+void ModuleMemoryPolicy::setModuleMemory(const QHash<QString, double>& memoryMb)
+{
+    m_memoryMb = memoryMb;
+    // A module that was never called counts as idle from when it was first seen
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    for (auto it = memoryMb.constBegin(); it != memoryMb.constEnd(); ++it) {
+        if (!m_lastActivity.contains(it.key())) {
+            m_lastActivity.insert(it.key(), now);
+        }
+    }
+}
+
+void ModuleMemoryPolicy::noteModuleCall(const QString& module)
+{
+    m_lastActivity.insert(module, QDateTime::currentDateTimeUtc());
+}
+
+void ModuleMemoryPolicy::forgetModule(const QString& module)
+{
+    m_memoryMb.remove(module);
+    m_lastActivity.remove(module);
+}
+
+void ModuleMemoryPolicy::setModuleDependencies(const QHash<QString, QStringList>& dependencies)
+{
+    m_dependencies = dependencies;
+}
+
+double ModuleMemoryPolicy::memoryPressure()
+{
+    QFile file("/proc/pressure/memory");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+    // some avg10=1.23 avg60=0.50 avg300=0.10 total=12345
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray& line : lines) {
+        if (!line.startsWith("some ")) {
+            continue;
+        }
+        for (const QByteArray& field : line.split(' ')) {
+            if (field.startsWith("avg10=")) {
+                return field.mid(6).toDouble();
+            }
+        }
+    }
+    return -1;
+}
+
+QString ModuleMemoryPolicy::auditLogPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/logs/module-memory-policy.log";
+}
+
+QStringList ModuleMemoryPolicy::unloadCandidates(QStringList* skipped) const
+{
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    // Every loaded module is in m_memoryMb; unloading one of their dependencies would break them
+    QHash<QString, QString> neededBy;
+    for (auto it = m_memoryMb.constBegin(); it != m_memoryMb.constEnd(); ++it) {
+        for (const QString& dependency : m_dependencies.value(it.key())) {
+            neededBy.insert(dependency, it.key());
+        }
+    }
+
+    QStringList candidates;
+    for (auto it = m_memoryMb.constBegin(); it != m_memoryMb.constEnd(); ++it) {
+        const QString& module = it.key();
+        if (m_pinned.contains(module)) {
+            *skipped << module + " (pinned)";
+        } else if (m_leases && m_leases->isPinned(module)) {
+            *skipped << module + " (loaded by hand or before the apps using it)";
+        } else if (neededBy.contains(module)) {
+            *skipped << module + " (needed by " + neededBy.value(module) + ")";
+        } else if (m_leases && m_leases->leaseCount(module) > 0) {
+            *skipped << module + " (in use by an app)";
+        } else if (m_lastActivity.value(module, now).secsTo(now) < m_idleSeconds) {
+            *skipped << module + " (not idle)";
+        } else {
+            candidates << module;
+        }
+    }
+    // Largest first, so as few modules as possible are unloaded
+    std::sort(candidates.begin(), candidates.end(), [this](const QString& a, const QString& b) {
+        return m_memoryMb.value(a) > m_memoryMb.value(b);
+    });
+    return candidates;
+}
+
+void ModuleMemoryPolicy::evaluate()
+{
+    if (!m_enabled || m_memoryMb.isEmpty()) {
+        return;
+    }
+
+    double totalMb = 0;
+    for (double memory : m_memoryMb) {
+        totalMb += memory;
+    }
+    const double pressure = memoryPressure();
+    const bool overBudget = m_budgetMb > 0 && totalMb > m_budgetMb;
+    const bool underPressure = m_pressureThreshold > 0 && pressure >= m_pressureThreshold;
+    if (!overBudget && !underPressure) {
+        m_lastIdleReason.clear();
+        return;
+    }
+
+    const QString trigger = overBudget
+        ? QString("modules use %1 MB of a %2 MB budget").arg(totalMb, 0, 'f', 1).arg(m_budgetMb, 0, 'f', 0)
+        : QString("memory pressure %1% >= %2%").arg(pressure, 0, 'f', 2).arg(m_pressureThreshold);
+
+    QStringList skipped;
+    const QStringList candidates = unloadCandidates(&skipped);
+    if (candidates.isEmpty()) {
+        // Logged once until the situation changes
+        skipped.sort();
+        const QString key = QString(overBudget ? "budget: " : "pressure: ") + skipped.join(", ");
+        if (key != m_lastIdleReason) {
+            m_lastIdleReason = key;
+            audit("keep", QString(), trigger + "; nothing to unload: " + skipped.join(", "), totalMb, pressure);
+        }
+        return;
+    }
+    m_lastIdleReason.clear();
+
+    double remainingMb = totalMb;
+    for (const QString& module : candidates) {
+        const double memory = m_memoryMb.value(module);
+        const qint64 idleSeconds = m_lastActivity.value(module).secsTo(QDateTime::currentDateTimeUtc());
+        const QString reason = QString("%1; idle for %2 s, %3 MB").arg(trigger).arg(idleSeconds).arg(memory, 0, 'f', 1);
+        audit("unload", module, reason, totalMb, pressure);
+        forgetModule(module);
+        emit unloadRequested(module, reason);
+
+        remainingMb -= memory;
+        // Pressure is an average over 10 s; give it time to react before unloading more
+        if (!overBudget || remainingMb <= m_budgetMb) {
+            break;
+        }
+    }
+}
+
+void ModuleMemoryPolicy::audit(const QString& action, const QString& module, const QString& reason,
+                               double totalMb, double pressure)
+{
+    QJsonObject entry;
+    entry["time"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    entry["action"] = action;
+    if (!module.isEmpty()) {
+        entry["module"] = module;
+        entry["memoryMb"] = m_memoryMb.value(module);
+    }
+    entry["reason"] = reason;
+    entry["totalMb"] = totalMb;
+    entry["budgetMb"] = m_budgetMb;
+    entry["pressureAvg10"] = pressure;
+    qInfo() << "ModuleMemoryPolicy:" << action << module << "-" << reason;
+
+    const QString path = auditLogPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "ModuleMemoryPolicy: cannot write audit log" << path << ":" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(entry).toJson(QJsonDocument::Compact) + '\n');
+}
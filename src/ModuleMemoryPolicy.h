@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class ModuleLeaseManager;
+class QTimer;
+
+// Unloads idle core modules when they use too much memory.
+//
+// Every evaluation compares the modules' total memory (from the core's module
+// stats) with the budget and reads the system memory pressure (Linux PSI,
+// /proc/pressure/memory "some avg10"). When either is exceeded, idle modules are
+// unloaded, largest first: until the total fits the budget, or one per evaluation
+// under pressure. A module is idle when no bridge call reached it for idleSeconds.
+// Modules on the pin list, package_manager, modules loaded by hand (pinned by the
+// lease manager), modules held by open UI apps and modules that a loaded module
+// lists in its "dependencies" are never unloaded: a dependency is called by its
+// dependents rather than through the bridge, so it always looks idle. Every
+// decision is appended to a JSON-lines audit log.
+//
+// Configured in settings.ini:
+//
+//   [memoryPolicy]
+//   enabled=true
+//   budgetMb=2048              ; 0 disables the budget
+//   pressureThreshold=10       ; PSI some avg10 in percent, 0 disables
+//   idleSeconds=300
+//   intervalSeconds=10
+//   pinned=chat, wallet
+class ModuleMemoryPolicy : public QObject {
+    Q_OBJECT
+public:
+    explicit ModuleMemoryPolicy(ModuleLeaseManager* leases, QObject* parent = nullptr);
+
+    void loadSettings();
+    bool isEnabled() const { return m_enabled; }
+
+    // Latest memory use of each loaded module in MB
+    void setModuleMemory(const QHash<QString, double>& memoryMb);
+    // A call reached the module (bridge or Modules view)
+    void noteModuleCall(const QString& module);
+    void forgetModule(const QString& module);
+    // "dependencies" from each core module's metadata, by module name
+    void setModuleDependencies(const QHash<QString, QStringList>& dependencies);
+
+    // PSI "some avg10" of /proc/pressure/memory, or -1 where unavailable
+    static double memoryPressure();
+    static QString auditLogPath();
+
+    void evaluate();
+
+signals:
+    void unloadRequested(const QString& module, const QString& reason);
+
+private:
+    QStringList unloadCandidates(QStringList* skipped) const;
+    void audit(const QString& action, const QString& module, const QString& reason, double totalMb, double pressure);
+
+    ModuleLeaseManager* m_leases;
+    QTimer* m_timer;
+    bool m_enabled;
+    double m_budgetMb;
+    double m_pressureThreshold;
+    int m_idleSeconds;
+    QSet<QString> m_pinned;
+    QHash<QString, double> m_memoryMb;
+    QHash<QString, QDateTime> m_lastActivity;
+    QHash<QString, QStringList> m_dependencies;
+    QString m_lastIdleReason;
+};
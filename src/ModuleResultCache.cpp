@@ -0,0 +1,147 @@
+#include "ModuleResultCache.h"
+#include "ModuleCallDispatcher.h"
+#include "ModuleCallPolicy.h"
+
+#include <QDebug>
+
+#include "logos_api.h"
+#include "logos_api_client.h"
+
+namespace {
+
+// Results kept at most; the least recently used go first
+const int kMaxEntries = 2000;
+
+}
+
+ModuleResultCache::ModuleResultCache(LogosAPI* logosAPI, const ModuleCallPolicy* policy, QObject* parent)
+    : QObject(parent)
+    , m_logosAPI(logosAPI)
+    , m_policy(policy)
+    , m_entries(kMaxEntries)
+    , m_totalHits(0)
+    , m_totalMisses(0)
+{
+}
+
+bool ModuleResultCache::isCacheable(const QString& module, const QString& method) const
+{
+    return m_policy && m_policy->cacheTtlMs(module, method) > 0;
+}
+
+bool ModuleResultCache::lookup(const QString& module, const QString& method, const QVariantList& args, QVariant* result)
+{
+    // Without the invalidating events, cached results could go stale unnoticed
+    if (!isCacheable(module, method) || !subscribe(module)) {
+        return false;
+    }
+
+    Counters& counters = m_counters[module];
+    const QString key = ModuleCallDispatcher::callKey(module, method, args);
+    Entry* entry = m_entries.object(key);
+    if (entry && !entry->expires.hasExpired()) {
+        ++counters.hits;
+        ++m_totalHits;
+        *result = entry->result;
+        return true;
+    }
+    if (entry) {
+        m_entries.remove(key);
+    }
+    ++counters.misses;
+    ++m_totalMisses;
+    return false;
+}
+
+void ModuleResultCache::store(const QString& module,
+                              const QString& method,
+                              const QVariantList& args,
+                              const QVariant& result,
+                              quint64 generation)
+{
+    // An event arrived while the call was running; the result may already be stale
+    if (generation != m_generations.value(module) || !isCacheable(module, method)
+        || !m_subscribedModules.contains(module)) {
+        return;
+    }
+    Entry* entry = new Entry;
+    entry->module = module;
+    entry->method = method;
+    entry->result = result;
+    entry->expires.setRemainingTime(m_policy->cacheTtlMs(module, method));
+    m_entries.insert(ModuleCallDispatcher::callKey(module, method, args), entry);
+}
+
+void ModuleResultCache::invalidate(const QString& module, const QString& event)
+{
+    ++m_generations[module];
+    int dropped = 0;
+    const QList<QString> keys = m_entries.keys();
+    for (const QString& key : keys) {
+        const Entry* entry = m_entries.object(key);
+        if (entry && entry->module == module && m_policy->invalidatedBy(module, entry->method).contains(event)) {
+            m_entries.remove(key);
+            ++dropped;
+        }
+    }
+    if (dropped > 0) {
+        qDebug() << "ModuleResultCache:" << module << event << "dropped" << dropped << "cached results";
+    }
+}
+
+void ModuleResultCache::forget(const QString& module)
+{
+    ++m_generations[module];
+    m_subscribedModules.remove(module);
+    const QList<QString> keys = m_entries.keys();
+    for (const QString& key : keys) {
+        const Entry* entry = m_entries.object(key);
+        if (entry && entry->module == module) {
+            m_entries.remove(key);
+        }
+    }
+}
+
+QVariantMap ModuleResultCache::stats(const QString& module) const
+{
+    const Counters counters = m_counters.value(module);
+    QVariantMap result;
+    result["hits"] = counters.hits;
+    result["misses"] = counters.misses;
+    return result;
+}
+
+bool ModuleResultCache::subscribe(const QString& module)
+{
+    if (m_subscribedModules.contains(module)) {
+        return true;
+    }
+    const QStringList events = m_policy->invalidatingEvents(module);
+    if (!events.isEmpty()
+        && !(m_subscriber ? m_subscriber(module, events) : subscribeWithLogosAPI(module, events))) {
+        return false;
+    }
+    m_subscribedModules.insert(module);
+    return true;
+}
+
+bool ModuleResultCache::subscribeWithLogosAPI(const QString& module, const QStringList& events)
+{
+    // Tried again on the next lookup; nothing is cached meanwhile
+    LogosAPIClient* client = m_logosAPI ? m_logosAPI->getClient(module) : nullptr;
+    if (!client || !client->isConnected()) {
+        return false;
+    }
+    // What LogosModules::<module>.on(event) does, for modules without generated wrappers
+    QObject* replica = client->requestObject(module);
+    if (!replica) {
+        return false;
+    }
+    for (const QString& event : events) {
+        client->onEvent(replica, this, event, [this, module](const QString& eventName, const QVariantList&) {
+            invalidate(module, eventName);
+        });
+    }
+    qDebug() << "ModuleResultCache: invalidating cached" << module << "results on" << events;
+    return true;
+}
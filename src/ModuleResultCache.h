@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QCache>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+#include <functional>
+
+class LogosAPI;
+class ModuleCallPolicy;
+
+// Reuses results of pure read methods of core modules.
+//
+// Which methods are cached, for how long (cacheTtlMs) and which module events
+// drop them (invalidatedBy) comes from ModuleCallPolicy. The first lookup for a
+// module subscribes to its invalidating events, the same way the generated
+// LogosModules wrappers do for on(event). An event drops the cached results of
+// every method that lists it. Results of calls that were already running when an
+// event arrived are not stored (see generation()).
+//
+// Hits and misses are counted per module for the Modules view.
+class ModuleResultCache : public QObject {
+    Q_OBJECT
+public:
+    // Subscribes to events of module that must call invalidate(); false to try later
+    using Subscriber = std::function<bool(const QString& module, const QStringList& events)>;
+
+    ModuleResultCache(LogosAPI* logosAPI, const ModuleCallPolicy* policy, QObject* parent = nullptr);
+
+    // Replaces the LogosAPI event subscription for modules not yet subscribed (tests)
+    void setSubscriber(Subscriber subscriber) { m_subscriber = std::move(subscriber); }
+
+    bool isCacheable(const QString& module, const QString& method) const;
+    // Counts a hit or a miss for cacheable methods
+    bool lookup(const QString& module, const QString& method, const QVariantList& args, QVariant* result);
+    // Bumped by every invalidation of module; pass the value seen before the call
+    quint64 generation(const QString& module) const { return m_generations.value(module); }
+    void store(const QString& module,
+               const QString& method,
+               const QVariantList& args,
+               const QVariant& result,
+               quint64 generation);
+
+    void invalidate(const QString& module, const QString& event);
+    // Unloaded or reloaded: drop results and subscriptions
+    void forget(const QString& module);
+
+    // hits and misses of module
+    QVariantMap stats(const QString& module) const;
+    quint64 hits() const { return m_totalHits; }
+    quint64 misses() const { return m_totalMisses; }
+
+private:
+    struct Entry {
+        QString module;
+        QString method;
+        QVariant result;
+        QDeadlineTimer expires;
+    };
+
+    struct Counters {
+        quint64 hits = 0;
+        quint64 misses = 0;
+    };
+
+    // False while the module's invalidating events cannot be subscribed to
+    bool subscribe(const QString& module);
+    bool subscribeWithLogosAPI(const QString& module, const QStringList& events);
+
+    LogosAPI* m_logosAPI;
+    const ModuleCallPolicy* m_policy;
+    Subscriber m_subscriber;
+    QCache<QString, Entry> m_entries;
+    QHash<QString, quint64> m_generations;
+    QSet<QString> m_subscribedModules;
+    QHash<QString, Counters> m_counters;
+    quint64 m_totalHits;
+    quint64 m_totalMisses;
+};
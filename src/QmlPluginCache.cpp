@@ -0,0 +1,279 @@
+#include "QmlPluginCache.h"
+
+#include "restricted/DenyAllNAMFactory.h"
+#include "restricted/QmlEnginePool.h"
+#include "restricted/RestrictedUrlInterceptor.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QStandardPaths>
+#include <QUrl>
+
+namespace {
+
+// Mirrors the naming of Qt's QML disk cache (SHA-1 of the local source path plus
+// the source suffix with a trailing 'c'). Qt also validates entries against the
+// source timestamp, so a missed entry is only wasted space, never a stale load.
+QString diskCacheFileFor(const QString& directory, const QString& sourcePath)
+{
+    QCryptographicHash fileNameHash(QCryptographicHash::Sha1);
+    fileNameHash.addData(sourcePath.toUtf8());
+    const QString suffix = QFileInfo(sourcePath + QLatin1Char('c')).completeSuffix();
+    return directory + QString::fromUtf8(fileNameHash.result().toHex()) + QLatin1Char('.') + suffix;
+}
+
+}
+
+QmlPluginCache::QmlPluginCache(QObject* parent)
+    : QObject(parent)
+{
+}
+
+QmlPluginCache::~QmlPluginCache()
+{
+    releaseCompileEngine();
+}
+
+QString QmlPluginCache::cacheDirectory()
+{
+    QString directory = qEnvironmentVariable("QML_DISK_CACHE_PATH");
+    if (directory.isEmpty()) {
+        directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/qmlcache/";
+    }
+    if (!directory.endsWith(QLatin1Char('/'))) {
+        directory += QLatin1Char('/');
+    }
+    return directory;
+}
+
+bool QmlPluginCache::isDiskCacheDisabled()
+{
+    return qEnvironmentVariableIsSet("QML_DISABLE_DISK_CACHE");
+}
+
+QString QmlPluginCache::manifestPath(const QString& pluginName) const
+{
+    return cacheDirectory() + "manifests/" + pluginName + ".json";
+}
+
+QJsonObject QmlPluginCache::readManifest(const QString& pluginName) const
+{
+    QFile file(manifestPath(pluginName));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJsonObject();
+    }
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    return doc.isObject() ? doc.object() : QJsonObject();
+}
+
+bool QmlPluginCache::writeManifest(const QString& pluginName, const QJsonObject& manifest) const
+{
+    QDir().mkpath(QFileInfo(manifestPath(pluginName)).absolutePath());
+    QFile file(manifestPath(pluginName));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write QML cache manifest for plugin" << pluginName << ":" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(manifest).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+QStringList QmlPluginCache::sourceFiles(const QString& pluginPath)
+{
+    QStringList files;
+    QDirIterator it(pluginPath, QStringList() << "*.qml" << "*.js" << "*.mjs" << "qmldir",
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        files << QDir(pluginPath).relativeFilePath(it.next());
+    }
+    files.sort();
+    return files;
+}
+
+QString QmlPluginCache::contentHash(const QString& pluginPath, const QStringList& files)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    for (const QString& relativePath : files) {
+        QFile file(QDir(pluginPath).filePath(relativePath));
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        hash.addData(relativePath.toUtf8());
+        hash.addData(QByteArray(1, '\0'));
+        hash.addData(&file);
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QJsonObject QmlPluginCache::fileStamps(const QString& pluginPath, const QStringList& files)
+{
+    QJsonObject stamps;
+    for (const QString& relativePath : files) {
+        const QFileInfo info(QDir(pluginPath).filePath(relativePath));
+        QJsonObject stamp;
+        stamp["size"] = info.size();
+        stamp["mtime"] = info.lastModified().toMSecsSinceEpoch();
+        stamps[relativePath] = stamp;
+    }
+    return stamps;
+}
+
+bool QmlPluginCache::isUpToDate(const QString& pluginName, const QString& pluginPath) const
+{
+    const QJsonObject manifest = readManifest(pluginName);
+    if (manifest.isEmpty()) {
+        return false;
+    }
+    if (manifest.value("root").toString() != QDir(pluginPath).absolutePath()) {
+        return false;
+    }
+    return manifest.value("hash").toString() == contentHash(pluginPath, sourceFiles(pluginPath));
+}
+
+bool QmlPluginCache::looksUpToDate(const QString& pluginName, const QString& pluginPath) const
+{
+    const QJsonObject manifest = readManifest(pluginName);
+    if (manifest.isEmpty() || manifest.value("root").toString() != QDir(pluginPath).absolutePath()) {
+        return false;
+    }
+    // Also catches files that were added or removed
+    return manifest.value("stamps").toObject() == fileStamps(pluginPath, sourceFiles(pluginPath));
+}
+
+bool QmlPluginCache::precompile(const QString& pluginName, const QString& pluginPath)
+{
+    if (isDiskCacheDisabled()) {
+        qDebug() << "QML disk cache disabled, not precompiling plugin" << pluginName;
+        return false;
+    }
+
+    drop(pluginName);
+
+    const QStringList files = sourceFiles(pluginPath);
+    const QString absoluteRoot = QDir(pluginPath).absolutePath();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QQmlEngine* engine = compileEngine(pluginPath);
+
+    QJsonArray compiledFiles;
+    int failures = 0;
+    for (const QString& relativePath : files) {
+        if (!relativePath.endsWith(QLatin1String(".qml"))) {
+            continue;
+        }
+        // Compiling is enough for Qt to write the cache entry; nothing is instantiated
+        const QString filePath = QDir(pluginPath).filePath(relativePath);
+        QQmlComponent component(engine, QUrl::fromLocalFile(filePath), QQmlComponent::PreferSynchronous);
+        if (component.isError()) {
+            ++failures;
+            qWarning() << "Failed to precompile" << filePath << ":" << component.errorString();
+            continue;
+        }
+        compiledFiles.append(filePath);
+    }
+
+    const qint64 compileMs = timer.elapsed();
+
+    QJsonObject manifest;
+    manifest["plugin"] = pluginName;
+    manifest["root"] = absoluteRoot;
+    manifest["hash"] = contentHash(pluginPath, files);
+    manifest["stamps"] = fileStamps(pluginPath, files);
+    manifest["files"] = compiledFiles;
+    manifest["failures"] = failures;
+    manifest["compileMs"] = compileMs;
+    manifest["compiledAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+    if (!writeManifest(pluginName, manifest)) {
+        return false;
+    }
+
+    qDebug() << "Precompiled QML plugin" << pluginName << ":" << compiledFiles.size() << "files in"
+             << compileMs << "ms" << (failures ? QString("(%1 failed)").arg(failures) : QString());
+    return failures == 0;
+}
+
+QQmlEngine* QmlPluginCache::compileEngine(const QString& pluginPath)
+{
+    if (!m_engine) {
+        // Same sandbox as at runtime
+        m_namFactory = std::make_unique<DenyAllNAMFactory>();
+        m_interceptor = std::make_unique<RestrictedUrlInterceptor>(QStringList());
+        m_engine = std::make_unique<QQmlEngine>();
+        m_engine->setNetworkAccessManagerFactory(m_namFactory.get());
+        m_engine->addUrlInterceptor(m_interceptor.get());
+    }
+
+    // Only this plugin's files are reachable, and nothing compiled for the previous
+    // one (or for an older version of this one) is reused
+    if (!m_enginePluginPath.isEmpty()) {
+        m_interceptor->removeAllowedRoot(m_enginePluginPath);
+    }
+    m_interceptor->addAllowedRoot(pluginPath);
+    m_enginePluginPath = pluginPath;
+    m_engine->clearComponentCache();
+
+    QStringList importPaths = QmlEnginePool::baseImportPaths();
+    importPaths << pluginPath;
+    QmlEnginePool::configureRestrictedEngine(m_engine.get(), importPaths);
+    m_engine->setBaseUrl(QUrl::fromLocalFile(pluginPath + "/"));
+    return m_engine.get();
+}
+
+void QmlPluginCache::releaseCompileEngine()
+{
+    if (m_engine) {
+        m_engine->removeUrlInterceptor(m_interceptor.get());
+    }
+    m_engine.reset();
+    m_interceptor.reset();
+    m_namFactory.reset();
+    m_enginePluginPath.clear();
+}
+
+void QmlPluginCache::drop(const QString& pluginName)
+{
+    const QJsonObject manifest = readManifest(pluginName);
+    if (manifest.isEmpty()) {
+        return;
+    }
+
+    const QString directory = cacheDirectory();
+    for (const QJsonValue& value : manifest.value("files").toArray()) {
+        const QString filePath = value.toString();
+        QFile::remove(diskCacheFileFor(directory, filePath));
+        QFile::remove(diskCacheFileFor(directory, QDir::cleanPath(filePath)));
+    }
+    QFile::remove(manifestPath(pluginName));
+    qDebug() << "Dropped QML cache for plugin" << pluginName;
+}
+
+bool QmlPluginCache::ensureFresh(const QString& pluginName, const QString& pluginPath)
+{
+    if (isUpToDate(pluginName, pluginPath)) {
+        qDebug() << "QML cache hit for plugin" << pluginName;
+        // Same content with new file times (e.g. reinstalled); keeps launch checks hitting
+        if (!looksUpToDate(pluginName, pluginPath)) {
+            QJsonObject manifest = readManifest(pluginName);
+            manifest["stamps"] = fileStamps(pluginPath, sourceFiles(pluginPath));
+            writeManifest(pluginName, manifest);
+        }
+        return true;
+    }
+
+    qDebug() << "QML cache for plugin" << pluginName << "is missing or stale, rebuilding";
+    precompile(pluginName, pluginPath);
+    return false;
+}
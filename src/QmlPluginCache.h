@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+class DenyAllNAMFactory;
+class QQmlEngine;
+class RestrictedUrlInterceptor;
+
+// Install-time precompilation of third-party QML plugins.
+//
+// A plugin's QML is compiled with a sandboxed engine when it is installed or first
+// seen, which makes Qt write the compilation units to the QML disk cache under
+// AppDataLocation/qmlcache. A manifest per plugin records the content hash of the
+// plugin's QML/JS sources and their sizes and modification times. Launching a plugin
+// only compares sizes and times; on a mismatch the plugin is loaded from source and
+// handed back for idle-time precompilation, where the content hash decides whether
+// its cache entries are dropped and rebuilt.
+//
+// Plugins are compiled one after another with a single sandboxed engine, which is
+// pointed at each plugin in turn and kept until releaseCompileEngine().
+class QmlPluginCache : public QObject {
+    Q_OBJECT
+public:
+    explicit QmlPluginCache(QObject* parent = nullptr);
+    ~QmlPluginCache();
+
+    // QML_DISK_CACHE_PATH, which the app sets before any thread starts, or
+    // AppDataLocation/qmlcache where Qt puts the cache by default
+    static QString cacheDirectory();
+    static bool isDiskCacheDisabled();
+
+    // Hashes every source file; for install and idle time
+    bool isUpToDate(const QString& pluginName, const QString& pluginPath) const;
+    // Only compares file sizes and modification times; cheap enough for launch
+    bool looksUpToDate(const QString& pluginName, const QString& pluginPath) const;
+    bool precompile(const QString& pluginName, const QString& pluginPath);
+    void drop(const QString& pluginName);
+
+    // Rebuilds a stale or missing cache, or records new file times when only those
+    // changed; returns true when the existing cache was valid
+    bool ensureFresh(const QString& pluginName, const QString& pluginPath);
+    // Frees the compile engine once no more plugins are waiting to be compiled
+    void releaseCompileEngine();
+
+private:
+    // The compile engine, set up for pluginPath
+    QQmlEngine* compileEngine(const QString& pluginPath);
+    QString manifestPath(const QString& pluginName) const;
+    QJsonObject readManifest(const QString& pluginName) const;
+    bool writeManifest(const QString& pluginName, const QJsonObject& manifest) const;
+    static QStringList sourceFiles(const QString& pluginPath);
+    static QString contentHash(const QString& pluginPath, const QStringList& files);
+    static QJsonObject fileStamps(const QString& pluginPath, const QStringList& files);
+
+    // Declared before the engine so they outlive it
+    std::unique_ptr<DenyAllNAMFactory> m_namFactory;
+    std::unique_ptr<RestrictedUrlInterceptor> m_interceptor;
+    std::unique_ptr<QQmlEngine> m_engine;
+    QString m_enginePluginPath;  // the plugin the interceptor admits
+};
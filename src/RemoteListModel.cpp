@@ -0,0 +1,309 @@
+#include "RemoteListModel.h"
+#include "LogosQmlBridge.h"
+
+#include <QDebug>
+#include <QJsonDocument>
+#include <QTimer>
+#include <QVariantMap>
+
+namespace {
+
+const int kModelDataRole = Qt::UserRole + 1;
+
+}
+
+RemoteListModel::RemoteListModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_pageSize(50)
+    , m_hasMore(false)
+    , m_pendingCallId(0)
+    , m_pendingRequest(0)
+    , m_requestSerial(0)
+    , m_complete(true)
+    , m_reloadScheduled(false)
+{
+    m_roleNames.insert(kModelDataRole, "modelData");
+}
+
+RemoteListModel::~RemoteListModel()
+{
+    cancelPending();
+}
+
+QObject* RemoteListModel::bridge() const
+{
+    return m_bridge.data();
+}
+
+void RemoteListModel::setBridge(QObject* bridge)
+{
+    LogosQmlBridge* logosBridge = qobject_cast<LogosQmlBridge*>(bridge);
+    if (bridge && !logosBridge) {
+        qWarning() << "RemoteListModel: bridge must be the logos object";
+    }
+    if (m_bridge == logosBridge) {
+        return;
+    }
+    cancelPending();
+    m_bridge = logosBridge;
+    emit bridgeChanged();
+    scheduleReload();
+}
+
+void RemoteListModel::setFetcher(Fetcher fetcher)
+{
+    cancelPending();
+    m_fetcher = std::move(fetcher);
+    scheduleReload();
+}
+
+void RemoteListModel::setModule(const QString& module)
+{
+    if (m_module == module) {
+        return;
+    }
+    m_module = module;
+    emit moduleChanged();
+    scheduleReload();
+}
+
+void RemoteListModel::setMethod(const QString& method)
+{
+    if (m_method == method) {
+        return;
+    }
+    m_method = method;
+    emit methodChanged();
+    scheduleReload();
+}
+
+void RemoteListModel::setArgs(const QVariantList& args)
+{
+    if (m_args == args) {
+        return;
+    }
+    m_args = args;
+    emit argsChanged();
+    scheduleReload();
+}
+
+void RemoteListModel::setPageSize(int pageSize)
+{
+    pageSize = qMax(1, pageSize);
+    if (m_pageSize == pageSize) {
+        return;
+    }
+    m_pageSize = pageSize;
+    emit pageSizeChanged();
+}
+
+void RemoteListModel::setRoles(const QStringList& roles)
+{
+    if (m_roles == roles) {
+        return;
+    }
+    m_roles = roles;
+    emit rolesChanged();
+    scheduleReload();
+}
+
+void RemoteListModel::classBegin()
+{
+    // Properties are set one by one while the component is created; load once at the end
+    m_complete = false;
+}
+
+void RemoteListModel::componentComplete()
+{
+    m_complete = true;
+    reload();
+}
+
+void RemoteListModel::scheduleReload()
+{
+    if (!m_complete || m_reloadScheduled) {
+        return;
+    }
+    // Coalesces several property changes in a row into one reload
+    m_reloadScheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        m_reloadScheduled = false;
+        reload();
+    });
+}
+
+void RemoteListModel::reload()
+{
+    cancelPending();
+
+    beginResetModel();
+    m_items.clear();
+    m_nextCursor = QVariant();
+    m_roleNames.clear();
+    m_roleNames.insert(kModelDataRole, "modelData");
+    updateRoleNames(QVariantList());
+    endResetModel();
+    emit countChanged();
+
+    setError(QString());
+    const bool hadMore = m_hasMore;
+    m_hasMore = (m_bridge || m_fetcher) && !m_module.isEmpty() && !m_method.isEmpty();
+    if (hadMore != m_hasMore) {
+        emit hasMoreChanged();
+    }
+    if (m_hasMore) {
+        requestPage();
+    }
+}
+
+QVariant RemoteListModel::get(int row) const
+{
+    return row >= 0 && row < m_items.size() ? m_items.at(row) : QVariant();
+}
+
+int RemoteListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_items.size();
+}
+
+QVariant RemoteListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_items.size()) {
+        return QVariant();
+    }
+    const QVariant& item = m_items.at(index.row());
+    if (role == kModelDataRole || role == Qt::DisplayRole) {
+        return item;
+    }
+    const QByteArray roleName = m_roleNames.value(role);
+    return roleName.isEmpty() ? QVariant() : item.toMap().value(QString::fromUtf8(roleName));
+}
+
+QHash<int, QByteArray> RemoteListModel::roleNames() const
+{
+    return m_roleNames;
+}
+
+bool RemoteListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_hasMore && m_pendingRequest == 0 && m_error.isEmpty();
+}
+
+void RemoteListModel::fetchMore(const QModelIndex& parent)
+{
+    if (canFetchMore(parent)) {
+        requestPage();
+    }
+}
+
+void RemoteListModel::requestPage()
+{
+    if ((!m_bridge && !m_fetcher) || m_pendingRequest != 0) {
+        return;
+    }
+
+    QVariantMap request;
+    request["cursor"] = m_nextCursor;
+    request["limit"] = m_pageSize;
+    QVariantList callArgs = m_args;
+    callArgs.append(request);
+
+    // Replies may outlive the model; only the current request is applied
+    QPointer<RemoteListModel> self(this);
+    const quint64 request = ++m_requestSerial;
+    m_pendingRequest = request;
+    auto done = [self, request](const QVariant& result, const QString& error) {
+        if (self) {
+            self->onPage(request, result, error);
+        }
+    };
+    if (m_fetcher) {
+        m_fetcher(m_module, m_method, callArgs, done);
+    } else {
+        m_pendingCallId = m_bridge->call(m_module, m_method, callArgs, done);
+    }
+    emit loadingChanged();
+}
+
+void RemoteListModel::onPage(quint64 request, const QVariant& result, const QString& error)
+{
+    if (request != m_pendingRequest) {
+        return;  // Superseded by a reload
+    }
+    m_pendingRequest = 0;
+    m_pendingCallId = 0;
+    emit loadingChanged();
+
+    QVariant page = result;
+    // Modules that return JSON text instead of an object
+    if (page.typeId() == QMetaType::QString) {
+        page = QJsonDocument::fromJson(page.toString().toUtf8()).toVariant();
+    }
+    const QVariantMap pageMap = page.toMap();
+    if (!error.isEmpty() || !pageMap.contains("items")) {
+        setError(error.isEmpty() ? QString("Expected {items, nextCursor} from %1.%2").arg(m_module, m_method) : error);
+        qWarning() << "RemoteListModel:" << m_module << m_method << ":" << m_error;
+        return;
+    }
+
+    const QVariantList items = pageMap.value("items").toList();
+    m_nextCursor = pageMap.value("nextCursor");
+    const bool hasMore = !m_nextCursor.isNull() && m_nextCursor.isValid() && !items.isEmpty();
+
+    if (!items.isEmpty()) {
+        if (m_items.isEmpty() && m_roleNames.size() == 1) {
+            // Roles are only known once the first item is seen
+            beginResetModel();
+            updateRoleNames(items);
+            m_items = items;
+            endResetModel();
+        } else {
+            beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + items.size() - 1);
+            m_items.append(items);
+            endInsertRows();
+        }
+        emit countChanged();
+    }
+
+    if (hasMore != m_hasMore) {
+        m_hasMore = hasMore;
+        emit hasMoreChanged();
+    }
+}
+
+void RemoteListModel::updateRoleNames(const QVariantList& items)
+{
+    QStringList names = m_roles;
+    if (names.isEmpty() && !items.isEmpty()) {
+        names = items.first().toMap().keys();
+    }
+    int role = kModelDataRole + 1;
+    for (const QString& name : names) {
+        if (name != "modelData") {
+            m_roleNames.insert(role++, name.toUtf8());
+        }
+    }
+}
+
+void RemoteListModel::cancelPending()
+{
+    if (m_pendingRequest == 0) {
+        return;
+    }
+    // 0: answered from the cache or failed at once; nothing to cancel
+    if (m_bridge && m_pendingCallId != 0) {
+        m_bridge->cancelCall(m_pendingCallId);
+    }
+    m_pendingRequest = 0;
+    m_pendingCallId = 0;
+    emit loadingChanged();
+}
+
+void RemoteListModel::setError(const QString& error)
+{
+    if (m_error == error) {
+        return;
+    }
+    m_error = error;
+    emit errorChanged();
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QPointer>
+#include <QQmlParserStatus>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <functional>
+
+class LogosQmlBridge;
+
+// A list model that pages its rows in from a core module method as a view scrolls.
+//
+// The method is called with args followed by one request object, and answers one
+// page:
+//
+//   request:  {"cursor": <nextCursor of the previous page, or null>, "limit": pageSize}
+//   response: {"items": [...], "nextCursor": <opaque value, or null/missing at the end>}
+//
+// The first page is requested when the model is complete or reset; views ask for
+// more through canFetchMore()/fetchMore(), so memory and the time to the first
+// frame depend on what has been scrolled to, not on the size of the whole list.
+// Items that are objects expose their keys as roles (from the roles property, or
+// else the keys of the first item), and every item is also available as modelData.
+//
+//   import Logos.Models 1.0
+//   ListView {
+//       model: RemoteListModel {
+//           bridge: logos
+//           module: "wallet"
+//           method: "listTransactions"
+//           args: [account]
+//       }
+//       delegate: Text { text: amount + " " + memo }
+//   }
+class RemoteListModel : public QAbstractListModel, public QQmlParserStatus {
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+    Q_PROPERTY(QObject* bridge READ bridge WRITE setBridge NOTIFY bridgeChanged)
+    Q_PROPERTY(QString module READ module WRITE setModule NOTIFY moduleChanged)
+    Q_PROPERTY(QString method READ method WRITE setMethod NOTIFY methodChanged)
+    Q_PROPERTY(QVariantList args READ args WRITE setArgs NOTIFY argsChanged)
+    Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize NOTIFY pageSizeChanged)
+    Q_PROPERTY(QStringList roles READ roles WRITE setRoles NOTIFY rolesChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(bool hasMore READ hasMore NOTIFY hasMoreChanged)
+    Q_PROPERTY(QString error READ error NOTIFY errorChanged)
+
+public:
+    // Requests one page of module.method; done is called later with the response
+    using Fetcher = std::function<void(const QString& module,
+                                       const QString& method,
+                                       const QVariantList& args,
+                                       std::function<void(const QVariant& result, const QString& error)> done)>;
+
+    explicit RemoteListModel(QObject* parent = nullptr);
+    ~RemoteListModel() override;
+
+    // Replaces the bridge call for pages requested from now on (tests)
+    void setFetcher(Fetcher fetcher);
+
+    QObject* bridge() const;
+    void setBridge(QObject* bridge);
+    QString module() const { return m_module; }
+    void setModule(const QString& module);
+    QString method() const { return m_method; }
+    void setMethod(const QString& method);
+    QVariantList args() const { return m_args; }
+    void setArgs(const QVariantList& args);
+    int pageSize() const { return m_pageSize; }
+    void setPageSize(int pageSize);
+    QStringList roles() const { return m_roles; }
+    void setRoles(const QStringList& roles);
+
+    int count() const { return m_items.size(); }
+    bool isLoading() const { return m_pendingRequest != 0; }
+    bool hasMore() const { return m_hasMore; }
+    QString error() const { return m_error; }
+
+    // Drops every row and requests the first page again
+    Q_INVOKABLE void reload();
+    Q_INVOKABLE QVariant get(int row) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    void classBegin() override;
+    void componentComplete() override;
+
+signals:
+    void bridgeChanged();
+    void moduleChanged();
+    void methodChanged();
+    void argsChanged();
+    void pageSizeChanged();
+    void rolesChanged();
+    void countChanged();
+    void loadingChanged();
+    void hasMoreChanged();
+    void errorChanged();
+
+private:
+    void scheduleReload();
+    void requestPage();
+    void onPage(quint64 request, const QVariant& result, const QString& error);
+    void cancelPending();
+    void setError(const QString& error);
+    void updateRoleNames(const QVariantList& items);
+
+    QPointer<LogosQmlBridge> m_bridge;
+    Fetcher m_fetcher;
+    QString m_module;
+    QString m_method;
+    QVariantList m_args;
+    int m_pageSize;
+    QStringList m_roles;
+
+    QVariantList m_items;
+    QVariant m_nextCursor;
+    bool m_hasMore;
+    QString m_error;
+    int m_pendingCallId;
+    quint64 m_pendingRequest;
+    quint64 m_requestSerial;
+    bool m_complete;
+    bool m_reloadScheduled;
+    QHash<int, QByteArray> m_roleNames;
+};
@@ -0,0 +1,64 @@
+#include "SharedBlobImageProvider.h"
+#include "SharedBlobStore.h"
+
+#include <QDebug>
+
+namespace {
+
+// Stands in for the dimension sourceSize leaves open
+const int kUnbounded = 1 << 24;
+
+void releaseBlob(void* blob)
+{
+    delete static_cast<std::shared_ptr<const SharedBlobStore::Blob>*>(blob);
+}
+
+}
+
+SharedBlobImageProvider::SharedBlobImageProvider(std::shared_ptr<SharedBlobStore> store)
+    : QQuickImageProvider(QQuickImageProvider::Image)
+    , m_store(std::move(store))
+{
+}
+
+QImage SharedBlobImageProvider::requestImage(const QString& id, QSize* size, const QSize& requestedSize)
+{
+    const std::shared_ptr<const SharedBlobStore::Blob> blob = m_store ? m_store->lookup(id) : nullptr;
+    if (!blob) {
+        qWarning() << "SharedBlobImageProvider: no blob" << id;
+        return QImage();
+    }
+
+    QImage image;
+    if (blob->format != QImage::Format_Invalid) {
+        // No copy: the image reads the mapping and holds a reference to it
+        image = QImage(blob->data,
+                       blob->width,
+                       blob->height,
+                       blob->stride,
+                       blob->format,
+                       releaseBlob,
+                       new std::shared_ptr<const SharedBlobStore::Blob>(blob));
+    } else {
+        const QByteArray encoded = QByteArray::fromRawData(reinterpret_cast<const char*>(blob->data), blob->size);
+        image = QImage::fromData(encoded);
+    }
+    if (image.isNull()) {
+        qWarning() << "SharedBlobImageProvider: blob" << id << "is not an image";
+        return QImage();
+    }
+
+    if (size) {
+        *size = image.size();
+    }
+    // sourceSize may set only one dimension
+    if (requestedSize.width() > 0 || requestedSize.height() > 0) {
+        const QSize bound(requestedSize.width() > 0 ? requestedSize.width() : kUnbounded,
+                          requestedSize.height() > 0 ? requestedSize.height() : kUnbounded);
+        const QSize target = image.size().scaled(bound, Qt::KeepAspectRatio);
+        if (target != image.size()) {
+            return image.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+    }
+    return image;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QQuickImageProvider>
+#include <memory>
+
+class SharedBlobStore;
+
+// Serves image://logosblob/<id> from SharedBlobStore.
+//
+// Raw pixel blobs become QImages over the shared mapping itself; the mapping stays
+// alive until Qt Quick has uploaded or dropped the image. Encoded images (PNG,
+// JPEG, ...) are decoded straight from the mapping.
+class SharedBlobImageProvider : public QQuickImageProvider {
+public:
+    explicit SharedBlobImageProvider(std::shared_ptr<SharedBlobStore> store);
+
+    QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
+
+private:
+    std::shared_ptr<SharedBlobStore> m_store;
+};
@@ -0,0 +1,283 @@
+#include "SharedBlobStore.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutexLocker>
+#include <QUuid>
+#include <QRegularExpression>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kHandleKey[] = "$blob";
+
+QImage::Format pixelFormat(const QString& name)
+{
+    static const QHash<QString, QImage::Format> formats = {
+        {"rgba8888", QImage::Format_RGBA8888},
+        {"rgba8888_premultiplied", QImage::Format_RGBA8888_Premultiplied},
+        {"rgbx8888", QImage::Format_RGBX8888},
+        {"argb32", QImage::Format_ARGB32},
+        {"argb32_premultiplied", QImage::Format_ARGB32_Premultiplied},
+        {"rgb32", QImage::Format_RGB32},
+        {"rgb888", QImage::Format_RGB888},
+        {"grayscale8", QImage::Format_Grayscale8},
+    };
+    return formats.value(name.toLower(), QImage::Format_Invalid);
+}
+
+#ifdef Q_OS_UNIX
+// Opens the object named by a handle from module read-only; -1 and error if it may
+// not be used. modulePid is the process logos_core reports for the module, or 0.
+int openHandle(const QString& module, qint64 modulePid, const QVariantMap& blob, QString* error)
+{
+    if (blob.contains("shm")) {
+        const QString name = blob.value("shm").toString();
+        static const QRegularExpression validName("^/[A-Za-z0-9._-]{1,250}$");
+        if (!validName.match(name).hasMatch()) {
+            *error = "Invalid shared memory name";
+            return -1;
+        }
+        // A module may only name its own objects, never another module's
+        if (!name.startsWith(QString("/logos-%1-").arg(module))) {
+            *error = QString("Shared memory name must start with /logos-%1-").arg(module);
+            return -1;
+        }
+        const int fd = shm_open(QFile::encodeName(name).constData(), O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0) {
+            *error = QString("Cannot open shared memory %1: %2").arg(name, qt_error_string(errno));
+        }
+        return fd;
+    }
+
+#ifdef Q_OS_LINUX
+    if (blob.contains("pid") && blob.contains("fd")) {
+        const qint64 pid = blob.value("pid").toLongLong();
+        const int remoteFd = blob.value("fd").toInt();
+        if (pid <= 0 || pid == QCoreApplication::applicationPid() || remoteFd < 0) {
+            *error = "Invalid memfd handle";
+            return -1;
+        }
+        // Only the module's own process; never our descriptors or another module's
+        if (pid != modulePid) {
+            *error = QString("memfd does not belong to %1").arg(module);
+            return -1;
+        }
+        const QString path = QString("/proc/%1/fd/%2").arg(pid).arg(remoteFd);
+        if (!QFile::symLinkTarget(path).startsWith("/memfd:")) {
+            *error = "Handle does not name a memfd";
+            return -1;
+        }
+        const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            *error = QString("Cannot open memfd: %1").arg(qt_error_string(errno));
+            return -1;
+        }
+        // A producer that truncates the memfd would crash us on the next read
+        const int seals = fcntl(fd, F_GET_SEALS);
+        if (seals < 0 || !(seals & F_SEAL_SHRINK)) {
+            ::close(fd);
+            *error = "memfd is not sealed against shrinking";
+            return -1;
+        }
+        return fd;
+    }
+#endif
+
+    *error = "Unsupported blob handle";
+    return -1;
+}
+
+// Reads size bytes from the start of fd; false if the object ends early
+bool readAll(int fd, char* data, qint64 size)
+{
+    qint64 done = 0;
+    while (done < size) {
+        const ssize_t count = ::pread(fd, data + done, static_cast<size_t>(size - done), done);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        done += count;
+    }
+    return true;
+}
+#endif
+
+}
+
+SharedBlobStore::Blob::~Blob()
+{
+#ifdef Q_OS_UNIX
+    if (m_mapping) {
+        munmap(m_mapping, static_cast<size_t>(m_mappingSize));
+    }
+#endif
+}
+
+bool SharedBlobStore::isHandle(const QVariant& value)
+{
+    if (value.typeId() != QMetaType::QVariantMap) {
+        return false;
+    }
+    const QVariantMap map = value.toMap();
+    return map.size() == 1 && map.value(kHandleKey).typeId() == QMetaType::QVariantMap;
+}
+
+void SharedBlobStore::setModulePids(const QHash<QString, qint64>& pids)
+{
+    QMutexLocker locker(&m_mutex);
+    m_modulePids = pids;
+}
+
+void SharedBlobStore::forgetModule(const QString& module)
+{
+    QMutexLocker locker(&m_mutex);
+    m_modulePids.remove(module);
+}
+
+QString SharedBlobStore::map(const QString& module, const QVariantMap& handle, QString* error)
+{
+    const QVariantMap blob = handle.value(kHandleKey).toMap();
+    const qint64 size = blob.value("size").toLongLong();
+    if (size <= 0) {
+        *error = "Invalid blob size";
+        return QString();
+    }
+
+    auto mapped = std::make_shared<Blob>();
+    mapped->size = size;
+    mapped->mime = blob.value("mime").toString();
+    if (mapped->mime == QLatin1String("image/x-raw")) {
+        mapped->width = blob.value("width").toInt();
+        mapped->height = blob.value("height").toInt();
+        mapped->stride = blob.value("stride").toInt();
+        mapped->format = pixelFormat(blob.value("format").toString());
+        const int bytesPerPixel = QImage::toPixelFormat(mapped->format).bitsPerPixel() / 8;
+        if (mapped->format == QImage::Format_Invalid || mapped->width <= 0 || mapped->height <= 0
+            || qint64(mapped->stride) < qint64(mapped->width) * bytesPerPixel
+            || qint64(mapped->stride) * mapped->height > size) {
+            *error = "Invalid raw image layout";
+            return QString();
+        }
+    }
+
+#ifdef Q_OS_UNIX
+    qint64 modulePid = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        modulePid = m_modulePids.value(module);
+    }
+    const int fd = openHandle(module, modulePid, blob, error);
+    if (fd < 0) {
+        return QString();
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < size) {
+        ::close(fd);
+        *error = "Blob is smaller than its handle says";
+        return QString();
+    }
+    if (blob.contains("shm")) {
+        // shm objects cannot be sealed, and one truncated under a mapping would crash
+        // us on the next read, so their bytes are copied out instead
+        mapped->m_copy = QByteArray(size, Qt::Uninitialized);
+        const bool complete = readAll(fd, mapped->m_copy.data(), size);
+        ::close(fd);
+        if (!complete) {
+            *error = "Blob is smaller than its handle says";
+            return QString();
+        }
+        mapped->data = reinterpret_cast<const uchar*>(mapped->m_copy.constData());
+        return insert(mapped);
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the object alive; the descriptor is no longer needed
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        *error = QString("Cannot map blob: %1").arg(qt_error_string(errno));
+        return QString();
+    }
+    mapped->m_mapping = mapping;
+    mapped->m_mappingSize = size;
+    mapped->data = static_cast<const uchar*>(mapping);
+    return insert(mapped);
+#else
+    Q_UNUSED(module);
+    *error = "Shared blobs are not supported on this platform";
+    return QString();
+#endif
+}
+
+QString SharedBlobStore::insert(std::shared_ptr<const Blob> blob)
+{
+    // Every plugin engine serves image://logosblob, so ids must not be guessable
+    const QString id = QUuid::createUuid().toString(QUuid::Id128);
+    QMutexLocker locker(&m_mutex);
+    m_blobs.insert(id, std::move(blob));
+    return id;
+}
+
+std::shared_ptr<const SharedBlobStore::Blob> SharedBlobStore::lookup(const QString& id) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_blobs.value(id);
+}
+
+void SharedBlobStore::release(const QString& id)
+{
+    std::shared_ptr<const Blob> blob;
+    {
+        QMutexLocker locker(&m_mutex);
+        blob = m_blobs.take(id);
+    }
+    // Unmapped here, or by the last image still using it
+}
+
+QString SharedBlobStore::imageUrl(const QString& id)
+{
+    return "image://logosblob/" + id;
+}
+
+QVariantMap SharedBlobStore::describe(const QString& id, const Blob& blob)
+{
+    QVariantMap description;
+    description["id"] = id;
+    description["size"] = blob.size;
+    description["mime"] = blob.mime;
+    if (blob.mime.startsWith("image/")) {
+        description["url"] = imageUrl(id);
+    }
+    if (blob.format != QImage::Format_Invalid) {
+        description["width"] = blob.width;
+        description["height"] = blob.height;
+    }
+    QVariantMap handle;
+    handle[kHandleKey] = description;
+    return handle;
+}
+
+int SharedBlobStore::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_blobs.size();
+}
+
+qint64 SharedBlobStore::mappedBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 bytes = 0;
+    for (const std::shared_ptr<const Blob>& blob : m_blobs) {
+        bytes += blob->size;
+    }
+    return bytes;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <QVariant>
+#include <QVariantMap>
+#include <memory>
+
+// Read-only mappings of binary payloads that core modules hand over in shared memory.
+//
+// Instead of returning the bytes, a module method returns a handle naming a POSIX
+// shared memory object or one of its own memfds:
+//
+//   {"$blob": {"shm": "/logos-wallet-42", "size": 1048576, "mime": "image/png"}}
+//   {"$blob": {"pid": 1234, "fd": 17, "size": 8294400, "mime": "image/x-raw",
+//              "width": 1920, "height": 1080, "stride": 7680, "format": "rgba8888"}}
+//
+// A module may only hand over its own objects: shm names must start with
+// /logos-<module>-, and memfds must belong to the process logos_core reports for
+// the module (setModulePids()). memfds must be sealed against shrinking
+// (F_SEAL_SHRINK) so the producer cannot truncate them under the mapping; the UI
+// maps them read-only and never copies them. shm objects cannot be sealed, so
+// their bytes are copied once when the handle arrives.
+//
+// Blobs are owned by whoever mapped them (a plugin's LogosQmlBridge) and unmapped
+// when released, once the last image still drawing from them is gone. lookup() may
+// be called from the QML image loading threads.
+class SharedBlobStore {
+public:
+    struct Blob {
+        Blob() = default;
+        Blob(const Blob&) = delete;
+        Blob& operator=(const Blob&) = delete;
+        ~Blob();
+
+        const uchar* data = nullptr;
+        qint64 size = 0;
+        QString mime;
+        // Raw pixels (mime image/x-raw) only
+        int width = 0;
+        int height = 0;
+        int stride = 0;
+        QImage::Format format = QImage::Format_Invalid;
+
+    private:
+        friend class SharedBlobStore;
+        void* m_mapping = nullptr;
+        qint64 m_mappingSize = 0;
+        QByteArray m_copy;  // shm objects
+    };
+
+    SharedBlobStore() = default;
+    SharedBlobStore(const SharedBlobStore&) = delete;
+    SharedBlobStore& operator=(const SharedBlobStore&) = delete;
+
+    static bool isHandle(const QVariant& value);
+
+    // Host process of each loaded module, from the module stats
+    void setModulePids(const QHash<QString, qint64>& pids);
+    void forgetModule(const QString& module);
+
+    // Maps the object a handle returned by module names; returns the blob id, or an
+    // empty string and error
+    QString map(const QString& module, const QVariantMap& handle, QString* error);
+    std::shared_ptr<const Blob> lookup(const QString& id) const;
+    void release(const QString& id);
+
+    // image://logosblob/<id>
+    static QString imageUrl(const QString& id);
+    // Handle with the module-side fields replaced by id and, for images, url
+    static QVariantMap describe(const QString& id, const Blob& blob);
+
+    int count() const;
+    qint64 mappedBytes() const;
+
+private:
+    QString insert(std::shared_ptr<const Blob> blob);
+
+    mutable QMutex m_mutex;
+    QHash<QString, std::shared_ptr<const Blob>> m_blobs;
+    QHash<QString, qint64> m_modulePids;
+};
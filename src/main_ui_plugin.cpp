@@ -1,5 +1,6 @@
 #include "main_ui_plugin.h"
 #include "MainContainer.h"
+#include "MainUIBackend.h"
 #include <QDebug>
 #include "logos_api.h"
 #include "token_manager.h"
@@ -9,6 +10,13 @@ MainUIPlugin::MainUIPlugin(QObject* parent)
     , m_mainContainer(nullptr)
     , m_logosAPI(nullptr)
 {
+#ifdef MAIN_UI_STATIC
+    // Resources in a static library are only registered when referenced
+    Q_INIT_RESOURCE(main_ui_resources);
+#ifndef MAIN_UI_QML_AOT
+    Q_INIT_RESOURCE(main_ui_qml);
+#endif
+#endif
     qDebug() << "MainUIPlugin created";
 }
 
@@ -47,4 +55,38 @@ void MainUIPlugin::destroyWidget(QWidget* widget)
             m_mainContainer = nullptr;
         }
     }
-} 
\ No newline at end of file
+} 
+void MainUIPlugin::setPackageManagerWidget(QWidget* widget)
+{
+    if (!m_mainContainer) {
+        qWarning() << "MainUIPlugin::setPackageManagerWidget called before createWidget";
+        return;
+    }
+    m_mainContainer->setPackageManagerWidget(widget);
+}
+
+void MainUIPlugin::installPlugin(const QString& filePath)
+{
+    if (!m_mainContainer) {
+        qWarning() << "MainUIPlugin::installPlugin called before createWidget";
+        return;
+    }
+    m_mainContainer->getBackend()->installPluginFromPath(filePath);
+}
+
+void MainUIPlugin::openApp(const QString& appName)
+{
+    if (!m_mainContainer) {
+        qWarning() << "MainUIPlugin::openApp called before createWidget";
+        return;
+    }
+    m_mainContainer->getBackend()->onAppLauncherClicked(appName);
+}
+
+void MainUIPlugin::setBackgroundMode(bool enabled)
+{
+    if (!m_mainContainer) {
+        return;
+    }
+    m_mainContainer->setBackgroundMode(enabled);
+}
@@ -20,6 +20,16 @@ public:
     Q_INVOKABLE QWidget* createWidget(LogosAPI* logosAPI = nullptr) override;
     void destroyWidget(QWidget* widget) override;
 
+    // Called by the app once package_manager_ui is loaded, possibly after the first frame
+    Q_INVOKABLE void setPackageManagerWidget(QWidget* widget);
+
+    // Entry points for launches forwarded by the app (single-instance mode)
+    Q_INVOKABLE void installPlugin(const QString& filePath);
+    Q_INVOKABLE void openApp(const QString& appName);
+
+    // Called by the app when its window is hidden to the tray/minimized or shown again
+    Q_INVOKABLE void setBackgroundMode(bool enabled);
+
 private:
     MainContainer* m_mainContainer;
     LogosAPI* m_logosAPI;
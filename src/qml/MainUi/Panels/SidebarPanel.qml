@@ -2,7 +2,7 @@ import QtQuick
 import QtQuick.Controls
 import QtQuick.Layouts
 import Logos.Theme
-import controls
+import MainUi.Controls
 
 Control {
     id: root
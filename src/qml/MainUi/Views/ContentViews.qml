@@ -0,0 +1,104 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+
+Item {
+    id: root
+
+    // Set by MainContainer (LOGOS_CONTENT_VIEW_UNLOAD_SECONDS); 0 keeps views loaded
+    readonly property int unloadAfterMs: typeof contentViewUnloadMs !== "undefined" ? contentViewUnloadMs : 0
+
+    // Backend index 1-3 mapped to 0-2; -1 while the Apps workspace is active
+    readonly property int activeViewIndex: backend.currentActiveSectionIndex - 1
+
+    // Each view is created on its first visit. A view hidden for longer than
+    // unloadAfterMs is destroyed again; views may implement saveState()/restoreState()
+    // to keep cheap UI state (tabs, selection) across a reload.
+    component LazyView: Loader {
+        required property int viewIndex
+        property double hiddenSince: 0
+        property var savedState: null
+        readonly property bool isCurrent: root.activeViewIndex === viewIndex
+
+        active: false
+
+        function activateIfCurrent() {
+            if (isCurrent) {
+                hiddenSince = 0
+                active = true
+            } else if (active && hiddenSince === 0) {
+                hiddenSince = Date.now()
+            }
+        }
+
+        function unloadIfStale(now) {
+            if (!active || isCurrent || hiddenSince === 0 || now - hiddenSince < root.unloadAfterMs) {
+                return
+            }
+            if (item && typeof item.saveState === "function") {
+                savedState = item.saveState()
+            }
+            active = false
+            hiddenSince = 0
+            console.log("ContentViews: unloaded view", viewIndex, "after being hidden")
+        }
+
+        onIsCurrentChanged: activateIfCurrent()
+        Component.onCompleted: activateIfCurrent()
+        onLoaded: {
+            if (savedState && typeof item.restoreState === "function") {
+                item.restoreState(savedState)
+            }
+        }
+    }
+
+    Rectangle {
+        anchors.fill: parent
+        color: "#1e1e1e"
+    }
+
+    // Content views stack (indices 1-3 from backend, mapped to 0-2 here)
+    // Index 0 (Apps/MDI) is handled by the C++ MdiView widget
+    StackLayout {
+        id: contentStack
+        anchors.fill: parent
+        
+        // Map backend index: 1=Dashboard, 2=Modules, 3=Settings
+        // to internal index: 0=Dashboard, 1=Modules, 2=Settings
+        currentIndex: Math.max(0, root.activeViewIndex)
+
+        // Dashboard (backend index 1 -> internal index 0)
+        LazyView {
+            id: dashboardView
+            viewIndex: 0
+            sourceComponent: Component { DashboardView {} }
+        }
+
+        // Modules (backend index 2 -> internal index 1)
+        LazyView {
+            id: modulesView
+            viewIndex: 1
+            sourceComponent: Component { ModulesView {} }
+        }
+
+        // Settings (backend index 3 -> internal index 2)
+        LazyView {
+            id: settingsView
+            viewIndex: 2
+            sourceComponent: Component { SettingsView {} }
+        }
+    }
+
+    Timer {
+        interval: Math.max(1000, root.unloadAfterMs / 4)
+        // Stale views are picked up once the window is shown again
+        running: root.unloadAfterMs > 0 && !backend.backgroundMode
+        repeat: true
+        onTriggered: {
+            const now = Date.now()
+            dashboardView.unloadIfStale(now)
+            modulesView.unloadIfStale(now)
+            settingsView.unloadIfStale(now)
+        }
+    }
+}
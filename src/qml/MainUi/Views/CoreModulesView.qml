@@ -153,6 +153,31 @@ Item {
                                         Layout.preferredWidth: 100
                                     }
 
+                                    // Health (only for loaded): calls fail fast while unhealthy
+                                    LogosText {
+                                        readonly property var health: modelData.health || ({})
+                                        text: {
+                                            if (!modelData.isLoaded)
+                                                return ""
+                                            if (health.state === "unhealthy")
+                                                return "Unhealthy: " + health.lastError
+                                            if (health.state === "probing")
+                                                return "Probing..."
+                                            let errors = Math.round((health.errorRate || 0) * 100)
+                                            let latency = health.latencyMs !== undefined && health.latencyMs !== null
+                                                ? health.latencyMs + " ms" : "-"
+                                            let cache = modelData.cache || {}
+                                            let lookups = (cache.hits || 0) + (cache.misses || 0)
+                                            let cached = lookups > 0
+                                                ? ", cache " + Math.round(100 * cache.hits / lookups) + "% of " + lookups : ""
+                                            return "Healthy " + latency + (errors > 0 ? ", " + errors + "% errors" : "") + cached
+                                        }
+                                        color: health.state === "unhealthy" ? "#F44336"
+                                             : health.state === "probing" ? "#FFB74D" : "#a0a0a0"
+                                        elide: Text.ElideRight
+                                        Layout.preferredWidth: 260
+                                    }
+
                                     Item { Layout.fillWidth: true }
 
                                     // Load/Unload button
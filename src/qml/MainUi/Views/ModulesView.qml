@@ -2,11 +2,29 @@ import QtQuick
 import QtQuick.Controls
 import QtQuick.Layouts
 import Logos.Controls
-import panels
+import MainUi.Panels
 
 Item {
     id: root
 
+    // Restored by ContentViews when the view is recreated after being unloaded
+    function saveState() {
+        const coreModules = coreModulesLoader.item
+        return {
+            tabIndex: tabBar.currentIndex,
+            selectedPlugin: coreModules ? coreModules.selectedPlugin : "",
+            showingMethods: coreModules ? coreModules.showingMethods : false
+        }
+    }
+
+    function restoreState(state) {
+        tabBar.currentIndex = state.tabIndex
+        if (coreModulesLoader.item) {
+            coreModulesLoader.item.selectedPlugin = state.selectedPlugin
+            coreModulesLoader.item.showingMethods = state.showingMethods
+        }
+    }
+
     Rectangle {
         anchors.fill: parent
         color: "#1e1e1e"
@@ -88,6 +106,7 @@ Item {
             
             onCurrentIndexChanged: {
                 if (currentIndex === 1) {
+                    coreModulesLoader.active = true;
                     backend.refreshCoreModules();
                 }
             }
@@ -97,9 +116,11 @@ Item {
                 id: uiModulesTab
             }
 
-            // Core Modules tab
-            CoreModulesView {
-                id: coreModulesTab
+            // Core Modules tab, created on first visit
+            Loader {
+                id: coreModulesLoader
+                active: false
+                sourceComponent: Component { CoreModulesView {} }
             }
         }
     }
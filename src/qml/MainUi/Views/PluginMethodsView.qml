@@ -10,20 +10,66 @@ Item {
     property string pluginName: ""
     property var methods: []
     property string resultText: ""
+    property int pendingCallId: 0
+    property int methodsCallId: 0
     
     signal backClicked()
     
     Component.onCompleted: loadMethods()
-    onPluginNameChanged: loadMethods()
+    Component.onDestruction: {
+        cancelPendingCall()
+        cancelMethodsCall()
+    }
+    onPluginNameChanged: {
+        cancelPendingCall()
+        resultText = ""
+        loadMethods()
+    }
+    
+    function cancelPendingCall() {
+        if (pendingCallId > 0) {
+            backend.cancelCoreModuleCall(pendingCallId)
+            pendingCallId = 0
+        }
+    }
+
+    function cancelMethodsCall() {
+        if (methodsCallId > 0) {
+            backend.cancelCoreModuleCall(methodsCallId)
+            methodsCallId = 0
+        }
+    }
+
+    function callMethod(methodName) {
+        cancelPendingCall()
+        resultText = "Calling " + methodName + "..."
+        let callId = 0
+        callId = backend.callCoreModuleMethodAsync(pluginName, methodName, "[]", function(result) {
+            if (root.pendingCallId === callId) {
+                root.pendingCallId = 0
+            }
+            root.resultText = result
+        })
+        pendingCallId = callId
+    }
     
     function loadMethods() {
+        cancelMethodsCall()
+        methods = []
         if (pluginName.length > 0) {
-            let methodsJson = backend.getCoreModuleMethods(pluginName)
-            try {
-                methods = JSON.parse(methodsJson)
-            } catch (e) {
-                methods = []
-            }
+            let callId = 0
+            callId = backend.callCoreModuleMethodAsync(pluginName, "getMethods", "[]", function(result) {
+                if (root.methodsCallId === callId) {
+                    root.methodsCallId = 0
+                }
+                try {
+                    let reply = JSON.parse(result)
+                    root.methods = Array.isArray(reply.result) ? reply.result : []
+                } catch (e) {
+                    root.methods = []
+                }
+            })
+            methodsCallId = callId
         }
     }
 
@@ -142,8 +188,7 @@ Item {
                                             }
 
                                             onClicked: {
-                                                let methodName = modelData.name || modelData
-                                                root.resultText = backend.callCoreModuleMethod(root.pluginName, methodName, "[]")
+                                                root.callMethod(modelData.name || modelData)
                                             }
                                         }
                                     }
@@ -0,0 +1,412 @@
+#include "restricted/QmlEnginePool.h"
+
+#include "restricted/DenyAllNAMFactory.h"
+#include "restricted/RestrictedUrlInterceptor.h"
+#include "SharedBlobImageProvider.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QProcessEnvironment>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQuickWidget>
+#include <QTimer>
+
+#include <utility>
+
+QmlEnginePool::QmlEnginePool(Mode mode, QObject* parent)
+    : QObject(parent)
+    , m_mode(mode)
+    , m_sharedPlugins(sharedPluginsFromEnvironment())
+    , m_prewarmTarget(0)
+    , m_refillScheduled(false)
+    , m_sharedEngine(nullptr)
+{
+    qDebug() << "QmlEnginePool mode:" << (m_mode == Mode::Shared ? "shared" : "isolated");
+    if (m_mode == Mode::Shared) {
+        qWarning() << "QmlEnginePool: plugins on the shared engine are not isolated from each other:"
+                   << QStringList(m_sharedPlugins.begin(), m_sharedPlugins.end());
+    }
+}
+
+QmlEnginePool::~QmlEnginePool()
+{
+    const QList<QObject*> widgets = m_slots.keys();
+    const QHash<QObject*, PluginSlot> slotsCopy = m_slots;
+    m_slots.clear();
+    for (QObject* widget : widgets) {
+        disconnect(widget, nullptr, this, nullptr);
+    }
+
+    // Idle widgets were never handed out, so they are ours to delete
+    for (QQuickWidget* widget : std::as_const(m_idleWidgets)) {
+        const PluginSlot slot = slotsCopy.value(widget);
+        if (slot.engine && slot.interceptor) {
+            slot.engine->removeUrlInterceptor(slot.interceptor);
+        }
+        delete slot.interceptor;
+        delete widget;
+    }
+    m_idleWidgets.clear();
+
+    if (m_sharedEngine) {
+        // Widgets on the shared engine cannot outlive it (unloads only deleteLater() them)
+        for (QObject* widget : widgets) {
+            if (slotsCopy.value(widget).engine == m_sharedEngine) {
+                delete widget;
+            }
+        }
+        m_sharedEngine->removeUrlInterceptor(m_sharedInterceptor.get());
+        delete m_sharedEngine;
+        m_sharedEngine = nullptr;
+    }
+}
+
+QmlEnginePool::Mode QmlEnginePool::modeFromEnvironment()
+{
+    const QString value = QProcessEnvironment::systemEnvironment().value("LOGOS_QML_SHARED_ENGINE", "");
+    if (value == QLatin1String("1") || value.compare(QLatin1String("true"), Qt::CaseInsensitive) == 0) {
+        return Mode::Shared;
+    }
+    return Mode::Isolated;
+}
+
+QSet<QString> QmlEnginePool::sharedPluginsFromEnvironment()
+{
+    QSet<QString> plugins;
+    const QString value = QProcessEnvironment::systemEnvironment().value("LOGOS_QML_SHARED_PLUGINS", "");
+    for (const QString& name : value.split(',', Qt::SkipEmptyParts)) {
+        if (!name.trimmed().isEmpty()) {
+            plugins.insert(name.trimmed());
+        }
+    }
+    return plugins;
+}
+
+int QmlEnginePool::prewarmCountFromEnvironment()
+{
+    bool ok = false;
+    const int count = QProcessEnvironment::systemEnvironment().value("LOGOS_QML_WIDGET_POOL_SIZE", "").toInt(&ok);
+    return ok && count >= 0 ? count : 2;
+}
+
+QStringList QmlEnginePool::baseImportPaths()
+{
+    return QStringList{
+        QStringLiteral("qrc:/qt-project.org/imports"),
+        QStringLiteral("qrc:/qt/qml")
+    };
+}
+
+void QmlEnginePool::configureRestrictedEngine(QQmlEngine* engine, const QStringList& importPaths)
+{
+    qDebug() << "=======================> QML import paths:" << importPaths;
+    engine->setImportPathList(importPaths);
+
+    QStringList pluginPaths;
+    // note: kept empty to lock the plugin down
+    // could cause issues with other QML components but it's unclear the moment
+    //const QString qtPluginPath = QLibraryInfo::path(QLibraryInfo::PluginsPath);
+    //if (!qtPluginPath.isEmpty()) {
+    //    pluginPaths << qtPluginPath;  // Required for QtQuick C++ backends
+    //}
+    qDebug() << "=======================> QML plugin paths:" << pluginPaths;
+    engine->setPluginPathList(pluginPaths);
+}
+
+void QmlEnginePool::warmUpEngine(QQmlEngine* engine) const
+{
+    // Resolves the Qt Quick and Controls imports once so the type loader has them cached
+    QElapsedTimer timer;
+    timer.start();
+    QQmlComponent warmUp(engine);
+    warmUp.setData("import QtQuick\nimport QtQuick.Controls\nItem {}\n", QUrl());
+    if (warmUp.isError()) {
+        qDebug() << "QmlEnginePool: warm-up component failed:" << warmUp.errorString();
+    }
+    qDebug() << "QmlEnginePool: engine warm-up took" << timer.elapsed() << "ms";
+}
+
+void QmlEnginePool::setBlobStore(std::shared_ptr<SharedBlobStore> store)
+{
+    m_blobStore = std::move(store);
+}
+
+void QmlEnginePool::addImageProviders(QQmlEngine* engine) const
+{
+    if (m_blobStore) {
+        // The engine owns the provider
+        engine->addImageProvider(QStringLiteral("logosblob"), new SharedBlobImageProvider(m_blobStore));
+    }
+}
+
+QQmlEngine* QmlEnginePool::sharedEngine()
+{
+    if (m_sharedEngine) {
+        return m_sharedEngine;
+    }
+
+    m_sharedEngine = new QQmlEngine(this);
+    configureRestrictedEngine(m_sharedEngine, baseImportPaths());
+
+    m_sharedNamFactory = std::make_unique<DenyAllNAMFactory>();
+    m_sharedEngine->setNetworkAccessManagerFactory(m_sharedNamFactory.get());
+
+    // Starts with no local roots; each plugin adds its own root while it is loaded
+    m_sharedInterceptor = std::make_unique<RestrictedUrlInterceptor>(QStringList());
+    m_sharedEngine->addUrlInterceptor(m_sharedInterceptor.get());
+    addImageProviders(m_sharedEngine);
+
+    warmUpEngine(m_sharedEngine);
+    qDebug() << "QmlEnginePool: created shared QML engine";
+    return m_sharedEngine;
+}
+
+void QmlEnginePool::updateSharedImportPaths()
+{
+    if (!m_sharedEngine) {
+        return;
+    }
+
+    QStringList importPaths = baseImportPaths();
+    for (const PluginSlot& slot : std::as_const(m_slots)) {
+        if (slot.shared && !slot.root.isEmpty() && !importPaths.contains(slot.root)) {
+            importPaths << slot.root;
+        }
+    }
+    m_sharedEngine->setImportPathList(importPaths);
+}
+
+QQuickWidget* QmlEnginePool::createIdleWidget(bool shared)
+{
+    QQuickWidget* qmlWidget = nullptr;
+    PluginSlot slot;
+    slot.shared = shared;
+
+    if (!shared) {
+        qmlWidget = new QQuickWidget;
+        QQmlEngine* engine = qmlWidget->engine();
+        if (engine) {
+            configureRestrictedEngine(engine, baseImportPaths());
+            engine->setNetworkAccessManagerFactory(new DenyAllNAMFactory());
+            // No roots until the widget is bound to a plugin
+            slot.interceptor = new RestrictedUrlInterceptor(QStringList());
+            engine->addUrlInterceptor(slot.interceptor);
+            addImageProviders(engine);
+            warmUpEngine(engine);
+        }
+        slot.engine = engine;
+        slot.context = qmlWidget->rootContext();
+    } else {
+        QQmlEngine* engine = sharedEngine();
+        qmlWidget = new QQuickWidget(engine, nullptr);
+        slot.engine = engine;
+    }
+
+    qmlWidget->setResizeMode(QQuickWidget::SizeRootObjectToView);
+    m_slots.insert(qmlWidget, slot);
+    connect(qmlWidget, &QObject::destroyed, this, &QmlEnginePool::onPluginWidgetDestroyed);
+    return qmlWidget;
+}
+
+void QmlEnginePool::bindToPlugin(QQuickWidget* qmlWidget, const QString& pluginName, const QString& pluginPath)
+{
+    PluginSlot& slot = m_slots[qmlWidget];
+    slot.name = pluginName;
+    slot.root = pluginPath;
+
+    if (!slot.shared) {
+        if (slot.engine) {
+            QStringList importPaths = baseImportPaths();
+            importPaths << pluginPath;     // Plugin-local imports only
+            qDebug() << "=======================> QML import paths:" << importPaths;
+            slot.engine->setImportPathList(importPaths);
+
+            slot.interceptor->addAllowedRoot(pluginPath);
+            qDebug() << "=======================> QML allowed roots:" << QStringList{pluginPath};
+            qDebug() << "=======================> QML base url:" << QUrl::fromLocalFile(pluginPath + "/");
+            slot.engine->setBaseUrl(QUrl::fromLocalFile(pluginPath + "/"));
+        }
+        return;
+    }
+
+    m_sharedInterceptor->addAllowedRoot(pluginPath);
+
+    // Per-plugin context: relative URLs resolve against the plugin root and
+    // context properties (e.g. "logos") are not visible to other plugins
+    QQmlContext* context = new QQmlContext(slot.engine->rootContext(), qmlWidget);
+    context->setBaseUrl(QUrl::fromLocalFile(pluginPath + "/"));
+    slot.context = context;
+    updateSharedImportPaths();
+    qDebug() << "QmlEnginePool: plugin" << pluginName << "joined shared engine, root:" << pluginPath;
+}
+
+QQuickWidget* QmlEnginePool::createPluginWidget(const QString& pluginName, const QString& pluginPath,
+                                                bool bundled)
+{
+    QQuickWidget* qmlWidget = nullptr;
+    if (m_mode == Mode::Shared && !(bundled && m_sharedPlugins.contains(pluginName))) {
+        // The shared interceptor admits every loaded plugin's root, so a plugin the
+        // host has not allowed keeps a sandbox of its own
+        qmlWidget = createIdleWidget(false);
+        qDebug() << "QmlEnginePool: plugin" << pluginName << "is not allowed on the shared engine";
+    } else if (!m_idleWidgets.isEmpty()) {
+        qmlWidget = m_idleWidgets.takeFirst();
+        qDebug() << "QmlEnginePool: using pre-warmed widget for" << pluginName;
+    } else {
+        qmlWidget = createIdleWidget(m_mode == Mode::Shared);
+    }
+
+    bindToPlugin(qmlWidget, pluginName, pluginPath);
+    scheduleRefill();
+    return qmlWidget;
+}
+
+void QmlEnginePool::setPrewarmTarget(int count, int delayMs)
+{
+    m_prewarmTarget = qMax(0, count);
+    scheduleRefill(delayMs);
+}
+
+void QmlEnginePool::scheduleRefill(int delayMs)
+{
+    if (m_refillScheduled || m_idleWidgets.size() >= m_prewarmTarget) {
+        return;
+    }
+    m_refillScheduled = true;
+    QTimer::singleShot(delayMs, this, &QmlEnginePool::refillOne);
+}
+
+void QmlEnginePool::refillOne()
+{
+    m_refillScheduled = false;
+    if (m_idleWidgets.size() >= m_prewarmTarget) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    m_idleWidgets.append(createIdleWidget(m_mode == Mode::Shared));
+    qDebug() << "QmlEnginePool: pre-warmed widget" << m_idleWidgets.size() << "/" << m_prewarmTarget
+             << "in" << timer.elapsed() << "ms";
+
+    // One widget per pass so the event loop stays responsive
+    scheduleRefill();
+}
+
+QQmlContext* QmlEnginePool::contextFor(QQuickWidget* widget) const
+{
+    auto it = m_slots.constFind(widget);
+    if (it == m_slots.constEnd() || !it->context) {
+        return widget ? widget->rootContext() : nullptr;
+    }
+    return it->context;
+}
+
+bool QmlEnginePool::setPluginSource(QQuickWidget* widget, const QUrl& source, QList<QQmlError>* errors)
+{
+    if (!widget) {
+        return false;
+    }
+
+    if (!m_slots.value(widget).shared) {
+        widget->setSource(source);
+        if (widget->status() == QQuickWidget::Error) {
+            if (errors) {
+                *errors = widget->errors();
+            }
+            return false;
+        }
+        return true;
+    }
+
+    // Shared engine: QQuickWidget::setSource() would instantiate in the engine's root
+    // context, so create the root object in the plugin's own context instead
+    QQmlContext* context = contextFor(widget);
+    QQmlComponent* component = new QQmlComponent(widget->engine(), source, QQmlComponent::PreferSynchronous, widget);
+    if (component->isError()) {
+        if (errors) {
+            *errors = component->errors();
+        }
+        component->deleteLater();
+        return false;
+    }
+
+    QObject* rootObject = component->create(context);
+    if (!rootObject) {
+        if (errors) {
+            *errors = component->errors();
+        }
+        component->deleteLater();
+        return false;
+    }
+
+    widget->setContent(source, component, rootObject);
+    return true;
+}
+
+void QmlEnginePool::renderFirstFrame(QQuickWidget* widget)
+{
+    if (!widget) {
+        return;
+    }
+
+    // A widget that was never shown has no scene graph, so grabFramebuffer() alone
+    // renders nothing. Showing it without mapping a window initializes the scene graph;
+    // the grab then runs polish, sync and a render. The image itself is not needed.
+    const bool wasVisible = widget->isVisible();
+    if (!wasVisible) {
+        widget->setAttribute(Qt::WA_DontShowOnScreen, true);
+        widget->show();
+    }
+    widget->grabFramebuffer();
+    if (!wasVisible) {
+        widget->hide();
+        widget->setAttribute(Qt::WA_DontShowOnScreen, false);
+    }
+}
+
+void QmlEnginePool::onPluginWidgetDestroyed(QObject* widget)
+{
+    m_idleWidgets.removeAll(static_cast<QQuickWidget*>(widget));
+
+    auto it = m_slots.find(widget);
+    if (it == m_slots.end()) {
+        return;
+    }
+
+    const PluginSlot slot = it.value();
+    m_slots.erase(it);
+
+    if (slot.interceptor) {
+        // The engine is a child of the widget and is still alive while destroyed() is emitted
+        if (slot.engine) {
+            slot.engine->removeUrlInterceptor(slot.interceptor);
+        }
+        delete slot.interceptor;
+    }
+
+    if (!slot.shared || !m_sharedEngine || slot.root.isEmpty()) {
+        return;
+    }
+
+    bool rootStillUsed = false;
+    for (const PluginSlot& other : std::as_const(m_slots)) {
+        if (other.shared && other.root == slot.root) {
+            rootStillUsed = true;
+            break;
+        }
+    }
+    if (!rootStillUsed) {
+        m_sharedInterceptor->removeAllowedRoot(slot.root);
+    }
+    updateSharedImportPaths();
+
+    // Drop the plugin's compiled components once its objects are gone; framework
+    // components still referenced by other plugins stay cached
+    QTimer::singleShot(0, m_sharedEngine, [engine = m_sharedEngine]() {
+        engine->trimComponentCache();
+    });
+    qDebug() << "QmlEnginePool: plugin" << slot.name << "left shared engine";
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QQmlError>
+#include <QSet>
+#include <QString>
+#include <QUrl>
+#include <memory>
+
+class QQmlContext;
+class QQmlEngine;
+class QQuickWidget;
+class DenyAllNAMFactory;
+class RestrictedUrlInterceptor;
+class SharedBlobStore;
+
+// Hands out sandboxed QQuickWidgets for QML plugins.
+//
+// Isolated mode (default) gives every plugin its own QQmlEngine, exactly as before.
+// Shared mode runs plugins on one engine so Qt Quick, the Controls style and common
+// components are imported and compiled once. Each plugin still gets its own
+// QQmlContext (with its own base URL and context properties), and the engine keeps
+// the restricted import/plugin paths and deny-all networking. Qt's URL interceptor
+// and import path list belong to the engine and cannot tell which context a request
+// comes from, so they admit the roots of every plugin on the shared engine: those
+// plugins can resolve each other's files. Shared mode is therefore not a sandbox
+// between plugins. The host decides which plugins join it, never the plugin: only
+// those named in LOGOS_QML_SHARED_PLUGINS and installed with the app (the caller
+// passes bundled). Every other plugin gets an isolated engine in either mode, and
+// with no list, none share.
+//
+// In both modes a few widgets can be pre-warmed at idle time: the widget, its
+// restricted engine and the Qt Quick imports are set up ahead of time, so launching
+// a plugin only binds the plugin root and loads its main QML file.
+class QmlEnginePool : public QObject {
+    Q_OBJECT
+public:
+    enum class Mode {
+        Isolated,
+        Shared
+    };
+
+    explicit QmlEnginePool(Mode mode, QObject* parent = nullptr);
+    ~QmlEnginePool();
+
+    // LOGOS_QML_SHARED_ENGINE=1 selects shared mode
+    static Mode modeFromEnvironment();
+    // LOGOS_QML_SHARED_PLUGINS, comma-separated plugin names
+    static QSet<QString> sharedPluginsFromEnvironment();
+    // LOGOS_QML_WIDGET_POOL_SIZE, defaults to 2 (0 disables pre-warming)
+    static int prewarmCountFromEnvironment();
+    Mode mode() const { return m_mode; }
+
+    // Restricted import/plugin path setup shared by every sandboxed engine
+    static QStringList baseImportPaths();
+    static void configureRestrictedEngine(QQmlEngine* engine, const QStringList& importPaths);
+
+    // Serves image://logosblob on every engine created from now on
+    void setBlobStore(std::shared_ptr<SharedBlobStore> store);
+
+    // Keeps this many unbound widgets ready, filled one per event loop pass after delayMs
+    void setPrewarmTarget(int count, int delayMs = 0);
+    int idleWidgetCount() const { return m_idleWidgets.size(); }
+
+    // bundled: pluginPath is in the app's own plugins directory, not the user's;
+    // together with the allow-list it decides whether the plugin shares the engine
+    QQuickWidget* createPluginWidget(const QString& pluginName, const QString& pluginPath,
+                                     bool bundled = false);
+
+    // Context that belongs to the plugin only; set per-plugin context properties here
+    QQmlContext* contextFor(QQuickWidget* widget) const;
+
+    bool setPluginSource(QQuickWidget* widget, const QUrl& source, QList<QQmlError>* errors = nullptr);
+
+    // Renders the first frame offscreen so the widget has content before it is shown
+    void renderFirstFrame(QQuickWidget* widget);
+
+private:
+    struct PluginSlot {
+        QString name;
+        QString root;
+        QPointer<QQmlContext> context;
+        QPointer<QQmlEngine> engine;
+        RestrictedUrlInterceptor* interceptor = nullptr;  // isolated engine, owned
+        bool shared = false;
+    };
+
+    QQmlEngine* sharedEngine();
+    void warmUpEngine(QQmlEngine* engine) const;
+    void addImageProviders(QQmlEngine* engine) const;
+    QQuickWidget* createIdleWidget(bool shared);
+    void bindToPlugin(QQuickWidget* widget, const QString& pluginName, const QString& pluginPath);
+    void scheduleRefill(int delayMs = 0);
+    void refillOne();
+    void updateSharedImportPaths();
+    void onPluginWidgetDestroyed(QObject* widget);
+
+    Mode m_mode;
+    QSet<QString> m_sharedPlugins;  // allowed onto the shared engine
+    QHash<QObject*, PluginSlot> m_slots;
+    QList<QQuickWidget*> m_idleWidgets;
+    std::shared_ptr<SharedBlobStore> m_blobStore;
+    int m_prewarmTarget;
+    bool m_refillScheduled;
+
+    // Shared mode only. The factory and interceptor are not owned by the engine,
+    // so they are kept here and outlive it.
+    std::unique_ptr<DenyAllNAMFactory> m_sharedNamFactory;
+    std::unique_ptr<RestrictedUrlInterceptor> m_sharedInterceptor;
+    QQmlEngine* m_sharedEngine;
+};
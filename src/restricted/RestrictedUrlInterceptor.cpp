@@ -1,17 +1,35 @@
 #include "restricted/RestrictedUrlInterceptor.h"
 
 #include <QDir>
+#include <QMutexLocker>
 
 RestrictedUrlInterceptor::RestrictedUrlInterceptor(const QStringList& allowedRoots)
 {
     for (const QString& root : allowedRoots) {
-        const QString canonical = QDir(root).canonicalPath();
-        if (!canonical.isEmpty()) {
-            m_allowedRoots.append(canonical);
-        }
+        addAllowedRoot(root);
+    }
+}
+
+void RestrictedUrlInterceptor::addAllowedRoot(const QString& root)
+{
+    const QString canonical = QDir(root).canonicalPath();
+    if (canonical.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_allowedRoots.contains(canonical)) {
+        m_allowedRoots.append(canonical);
     }
 }
 
+void RestrictedUrlInterceptor::removeAllowedRoot(const QString& root)
+{
+    const QString canonical = QDir(root).canonicalPath();
+    QMutexLocker locker(&m_mutex);
+    m_allowedRoots.removeAll(canonical);
+}
+
 QUrl RestrictedUrlInterceptor::intercept(const QUrl& url, DataType)
 {
     if (!url.isValid()) {
@@ -22,8 +40,14 @@ QUrl RestrictedUrlInterceptor::intercept(const QUrl& url, DataType)
         return url;
     }
 
+    // Images the app serves itself from module blobs (SharedBlobImageProvider)
+    if (url.scheme() == QLatin1String("image") && url.host() == QLatin1String("logosblob")) {
+        return url;
+    }
+
     if (url.isLocalFile()) {
         const QString local = QDir(url.toLocalFile()).canonicalPath();
+        QMutexLocker locker(&m_mutex);
         for (const QString& root : m_allowedRoots) {
             if (!root.isEmpty() && (local == root || local.startsWith(root + QLatin1Char('/')))) {
                 return url;
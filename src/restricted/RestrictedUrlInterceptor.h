@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QMutex>
 #include <QQmlAbstractUrlInterceptor>
 #include <QStringList>
 #include <QUrl>
@@ -9,6 +10,12 @@ public:
     explicit RestrictedUrlInterceptor(const QStringList& allowedRoots);
     QUrl intercept(const QUrl& url, DataType type) override;
 
+    // Roots can change while the engine is alive (shared engines gain and lose plugins).
+    // intercept() may run on the QML loader thread, so the list is guarded by a mutex.
+    void addAllowedRoot(const QString& root);
+    void removeAllowedRoot(const QString& root);
+
 private:
+    mutable QMutex m_mutex;
     QStringList m_allowedRoots;
 };
@@ -0,0 +1,175 @@
+#include <QSemaphore>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTest>
+#include <QThread>
+#include <atomic>
+
+#include "ModuleCallDispatcher.h"
+
+namespace {
+
+// Semaphores are only waited on with a timeout, so a failing test cannot leave a
+// pool thread blocked while the dispatcher waits for it
+const int kWaitMs = 5000;
+
+}
+
+class TestModuleCallDispatcher : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void deliversInCallOrder();
+    void dropsAbandonedStartedCall();
+    void allowsReentrantCallbacks();
+    void joinedCallSurvivesCancel();
+    void cancelledSharedCallIsMadeAgain();
+
+private:
+    ModuleCallDispatcher::Callback collect(QStringList* results)
+    {
+        return [results](const QVariant& result, const QString& error) {
+            *results << (error.isEmpty() ? result.toString() : "error:" + error);
+        };
+    }
+};
+
+void TestModuleCallDispatcher::initTestCase()
+{
+    // Keeps the user's module-call-policy.json out of the tests
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestModuleCallDispatcher::deliversInCallOrder()
+{
+    ModuleCallDispatcher dispatcher;
+    dispatcher.setConcurrency("wallet", 2);
+    dispatcher.setInvoker([](const QString&, const QString& method, const QVariantList& args,
+                             const std::atomic<bool>&, QString*) {
+        QThread::msleep(args.value(0).toInt());
+        return QVariant(method);
+    });
+
+    QStringList results;
+    dispatcher.call("wallet", "slow", {200}, this, collect(&results));
+    dispatcher.call("wallet", "fast", {0}, this, collect(&results));
+
+    QTRY_COMPARE(results, (QStringList{"slow", "fast"}));
+}
+
+void TestModuleCallDispatcher::dropsAbandonedStartedCall()
+{
+    QSemaphore started;
+    QSemaphore gate;
+    ModuleCallDispatcher dispatcher;
+    dispatcher.setInvoker([&](const QString&, const QString& method, const QVariantList&,
+                              const std::atomic<bool>&, QString*) {
+        if (method == "block") {
+            started.release();
+            gate.tryAcquire(1, kWaitMs);
+        }
+        return QVariant(method);
+    });
+
+    QStringList results;
+    const quint64 blocked = dispatcher.call("wallet", "block", {}, this, collect(&results));
+    dispatcher.call("wallet", "next", {}, this, collect(&results));
+    QVERIFY(started.tryAcquire(1, kWaitMs));
+
+    dispatcher.cancel(blocked);
+    // The stuck call gives its slot to the next one, which does not wait for it
+    QTRY_COMPARE(results, QStringList{"next"});
+    QCOMPARE(dispatcher.pendingCalls("wallet"), 1);
+    gate.release();
+
+    QTRY_COMPARE(dispatcher.pendingCalls("wallet"), 0);
+    QCOMPARE(results, QStringList{"next"});
+}
+
+void TestModuleCallDispatcher::allowsReentrantCallbacks()
+{
+    ModuleCallDispatcher dispatcher;
+    dispatcher.setInvoker([](const QString&, const QString& method, const QVariantList&,
+                             const std::atomic<bool>&, QString*) {
+        return QVariant(method);
+    });
+
+    QStringList results;
+    quint64 second = 0;
+    dispatcher.call("wallet", "first", {}, this, [&](const QVariant& result, const QString&) {
+        results << result.toString();
+        // Both run while the dispatcher is delivering
+        dispatcher.cancel(second);
+        dispatcher.call("wallet", "fourth", {}, this, collect(&results));
+    });
+    second = dispatcher.call("wallet", "second", {}, this, collect(&results));
+    dispatcher.call("wallet", "third", {}, this, collect(&results));
+
+    QTRY_COMPARE(results, (QStringList{"first", "third", "fourth"}));
+    QTRY_COMPARE(dispatcher.pendingCalls("wallet"), 0);
+}
+
+void TestModuleCallDispatcher::joinedCallSurvivesCancel()
+{
+    QSemaphore started;
+    QSemaphore gate;
+    std::atomic<int> invocations{0};
+    ModuleCallDispatcher dispatcher;
+    dispatcher.setInvoker([&](const QString&, const QString&, const QVariantList& args,
+                              const std::atomic<bool>&, QString*) {
+        ++invocations;
+        started.release();
+        gate.tryAcquire(1, kWaitMs);
+        return QVariant(args.value(0).toString());
+    });
+
+    QStringList firstResults;
+    QStringList secondResults;
+    const quint64 first = dispatcher.call("wallet", "balance", {"acct"}, this, collect(&firstResults));
+    dispatcher.call("wallet", "balance", {"acct"}, this, collect(&secondResults));
+    QCOMPARE(dispatcher.sharedCalls(), quint64(1));
+    QVERIFY(started.tryAcquire(1, kWaitMs));
+
+    dispatcher.cancel(first);
+    gate.release();
+
+    QTRY_COMPARE(secondResults, QStringList{"acct"});
+    QVERIFY(firstResults.isEmpty());
+    QCOMPARE(invocations.load(), 1);
+}
+
+void TestModuleCallDispatcher::cancelledSharedCallIsMadeAgain()
+{
+    QSemaphore started;
+    QSemaphore gate;
+    std::atomic<int> invocations{0};
+    ModuleCallDispatcher dispatcher;
+    dispatcher.setInvoker([&](const QString&, const QString&, const QVariantList&,
+                              const std::atomic<bool>&, QString*) {
+        const int invocation = ++invocations;
+        started.release();
+        gate.tryAcquire(1, kWaitMs);
+        return QVariant(invocation);
+    });
+
+    QStringList dropped;
+    const quint64 first = dispatcher.call("wallet", "balance", {"acct"}, this, collect(&dropped));
+    const quint64 second = dispatcher.call("wallet", "balance", {"acct"}, this, collect(&dropped));
+    QVERIFY(started.tryAcquire(1, kWaitMs));
+    dispatcher.cancel(first);
+    dispatcher.cancel(second);
+
+    // Nobody shares the abandoned call any more, so this one reaches the module again
+    QStringList results;
+    dispatcher.call("wallet", "balance", {"acct"}, this, collect(&results));
+    QCOMPARE(dispatcher.sharedCalls(), quint64(1));
+    gate.release(2);
+
+    QTRY_COMPARE(results, QStringList{"2"});
+    QVERIFY(dropped.isEmpty());
+    QCOMPARE(invocations.load(), 2);
+}
+
+QTEST_GUILESS_MAIN(TestModuleCallDispatcher)
+#include "tst_modulecalldispatcher.moc"
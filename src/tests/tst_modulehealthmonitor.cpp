@@ -0,0 +1,127 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include "ModuleHealthMonitor.h"
+
+class TestModuleHealthMonitor : public QObject {
+    Q_OBJECT
+
+private slots:
+    void tripsAfterConsecutiveFailures();
+    void tripsOnFailureRate();
+    void ignoresCallsFinishingAfterTrip();
+    void failedProbeKeepsCircuitOpen();
+    void successfulProbeClosesCircuit();
+    void forgetClosesCircuit();
+
+private:
+    void trip(ModuleHealthMonitor& monitor, const QString& module)
+    {
+        for (int i = 0; i < 5; ++i) {
+            monitor.recordFailure(module, "Timeout", 10);
+        }
+    }
+};
+
+void TestModuleHealthMonitor::tripsAfterConsecutiveFailures()
+{
+    ModuleHealthMonitor monitor;
+    for (int i = 0; i < 4; ++i) {
+        monitor.recordFailure("wallet", "Timeout", 10);
+    }
+    QVERIFY(monitor.allowCall("wallet"));
+
+    monitor.recordFailure("wallet", "Timeout", 10);
+    QString reason;
+    QVERIFY(!monitor.allowCall("wallet", &reason));
+    QCOMPARE(reason, QString("Module unavailable: Timeout"));
+    QCOMPARE(monitor.state("wallet"), ModuleHealthMonitor::State::Unhealthy);
+    // Other modules are not affected
+    QVERIFY(monitor.allowCall("chat"));
+}
+
+void TestModuleHealthMonitor::tripsOnFailureRate()
+{
+    ModuleHealthMonitor monitor;
+    // Never more than one failure in a row, but half of the window failed
+    for (int i = 0; i < 4; ++i) {
+        monitor.recordFailure("wallet", "Timeout", 10);
+        monitor.recordSuccess("wallet", 10);
+    }
+    QVERIFY(monitor.allowCall("wallet"));
+    monitor.recordFailure("wallet", "Timeout", 10);
+    QVERIFY(monitor.allowCall("wallet"));
+    monitor.recordSuccess("wallet", 10);
+    QVERIFY(!monitor.allowCall("wallet"));
+}
+
+void TestModuleHealthMonitor::ignoresCallsFinishingAfterTrip()
+{
+    ModuleHealthMonitor monitor;
+    monitor.setFirstProbeDelay(60000);
+    trip(monitor, "wallet");
+
+    monitor.recordSuccess("wallet", 10);
+    QVERIFY(!monitor.allowCall("wallet"));
+    QCOMPARE(monitor.health("wallet").value("errorRate").toDouble(), 1.0);
+}
+
+void TestModuleHealthMonitor::failedProbeKeepsCircuitOpen()
+{
+    ModuleHealthMonitor monitor;
+    monitor.setFirstProbeDelay(0);
+    QSignalSpy probes(&monitor, &ModuleHealthMonitor::probeRequested);
+    trip(monitor, "wallet");
+
+    QTRY_COMPARE(probes.count(), 1);
+    QCOMPARE(monitor.state("wallet"), ModuleHealthMonitor::State::Probing);
+    QVERIFY(!monitor.allowCall("wallet"));
+
+    monitor.recordProbe("wallet", false, "Module not connected");
+    QCOMPARE(monitor.state("wallet"), ModuleHealthMonitor::State::Unhealthy);
+    QVERIFY(!monitor.health("wallet").value("connected").toBool());
+    // Probed again later
+    QTRY_COMPARE(probes.count(), 2);
+}
+
+void TestModuleHealthMonitor::successfulProbeClosesCircuit()
+{
+    ModuleHealthMonitor monitor;
+    monitor.setFirstProbeDelay(0);
+    QSignalSpy probes(&monitor, &ModuleHealthMonitor::probeRequested);
+    monitor.recordSuccess("wallet", 40);
+    trip(monitor, "wallet");
+
+    QTRY_COMPARE(probes.count(), 1);
+    monitor.recordProbe("wallet", true, QString());
+    QVERIFY(monitor.allowCall("wallet"));
+    QCOMPARE(monitor.state("wallet"), ModuleHealthMonitor::State::Healthy);
+
+    const QVariantMap health = monitor.health("wallet");
+    QCOMPARE(health.value("errorRate").toDouble(), 0.0);
+    QCOMPARE(health.value("latencyMs").toInt(), 40);
+    QVERIFY(health.value("lastError").toString().isEmpty());
+
+    // A fresh start: four failures are not enough to trip again
+    for (int i = 0; i < 4; ++i) {
+        monitor.recordFailure("wallet", "Timeout", 10);
+    }
+    QVERIFY(monitor.allowCall("wallet"));
+}
+
+void TestModuleHealthMonitor::forgetClosesCircuit()
+{
+    ModuleHealthMonitor monitor;
+    monitor.setFirstProbeDelay(0);
+    QSignalSpy probes(&monitor, &ModuleHealthMonitor::probeRequested);
+    trip(monitor, "wallet");
+    monitor.forget("wallet");
+
+    QVERIFY(monitor.allowCall("wallet"));
+    // The probe scheduled before forget() finds nothing to do
+    QTest::qWait(20);
+    QCOMPARE(probes.count(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestModuleHealthMonitor)
+#include "tst_modulehealthmonitor.moc"
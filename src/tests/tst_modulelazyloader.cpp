@@ -0,0 +1,127 @@
+#include <QSemaphore>
+#include <QSignalSpy>
+#include <QTest>
+#include <atomic>
+
+#include "ModuleClientRegistry.h"
+#include "ModuleLazyLoader.h"
+#include "ModuleLeaseManager.h"
+
+namespace {
+
+// Semaphores are only waited on with a timeout, so a failing test cannot leave a
+// loader thread blocked while the loader's destructor waits for it
+const int kWaitMs = 5000;
+
+}
+
+// Without LogosAPI the registry never reports a module connected, so loads that
+// succeed end in the connection timeout
+class TestModuleLazyLoader : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void reportsFailedLoad();
+    void loadedButNeverConnectedTimesOut();
+    void lateSuccessIsLeasedToNobody();
+    void requestDuringTimedOutLoadWaitsForIt();
+
+private:
+    ModuleLeaseManager m_leases;
+    ModuleClientRegistry m_clients{nullptr};
+};
+
+void TestModuleLazyLoader::init()
+{
+    // Long enough that orphaned modules stay pending for the whole test
+    m_leases.setGracePeriod(60);
+    m_leases.forget("wallet");
+}
+
+void TestModuleLazyLoader::reportsFailedLoad()
+{
+    ModuleLazyLoader loader(nullptr, &m_leases, &m_clients);
+    loader.setLoader([](const QString&) { return false; });
+    QSignalSpy failed(&loader, &ModuleLazyLoader::moduleFailed);
+
+    loader.request("wallet", "app");
+    QVERIFY(loader.isLoading("wallet"));
+    QTRY_COMPARE(failed.count(), 1);
+    QCOMPARE(failed.at(0).at(0).toString(), QString("wallet"));
+    QCOMPARE(failed.at(0).at(1).toString(), QString("Module failed to load"));
+    QVERIFY(!loader.isLoading("wallet"));
+    QVERIFY(!m_leases.isUnloadPending("wallet"));
+}
+
+void TestModuleLazyLoader::loadedButNeverConnectedTimesOut()
+{
+    ModuleLazyLoader loader(nullptr, &m_leases, &m_clients);
+    loader.setTimeout(50);
+    loader.setLoader([](const QString&) { return true; });
+    QSignalSpy failed(&loader, &ModuleLazyLoader::moduleFailed);
+    QSignalSpy ready(&loader, &ModuleLazyLoader::moduleReady);
+
+    loader.request("wallet", "app");
+    QTRY_COMPARE(failed.count(), 1);
+    QCOMPARE(failed.at(0).at(1).toString(), QString("Module load timed out"));
+    QCOMPARE(ready.count(), 0);
+    // Nobody leases the loaded module, so it is unloaded again
+    QVERIFY(m_leases.isUnloadPending("wallet"));
+    QCOMPARE(m_leases.leaseCount("wallet"), 0);
+}
+
+void TestModuleLazyLoader::lateSuccessIsLeasedToNobody()
+{
+    QSemaphore gate;
+    std::atomic<int> loads{0};
+    ModuleLazyLoader loader(nullptr, &m_leases, &m_clients);
+    loader.setTimeout(50);
+    loader.setLoader([&](const QString&) {
+        ++loads;
+        return gate.tryAcquire(1, kWaitMs);
+    });
+    QSignalSpy failed(&loader, &ModuleLazyLoader::moduleFailed);
+
+    loader.request("wallet", "app");
+    QTRY_COMPARE(failed.count(), 1);
+    QCOMPARE(failed.at(0).at(1).toString(), QString("Module load timed out"));
+    // Callers were failed, but the load is still waited for
+    QVERIFY(loader.isLoading("wallet"));
+
+    gate.release();
+    QTRY_VERIFY(!loader.isLoading("wallet"));
+    QCOMPARE(loads.load(), 1);
+    QCOMPARE(failed.count(), 1);
+    QVERIFY(m_leases.isUnloadPending("wallet"));
+}
+
+void TestModuleLazyLoader::requestDuringTimedOutLoadWaitsForIt()
+{
+    QSemaphore gate;
+    std::atomic<int> loads{0};
+    ModuleLazyLoader loader(nullptr, &m_leases, &m_clients);
+    loader.setTimeout(200);
+    loader.setLoader([&](const QString&) {
+        ++loads;
+        return gate.tryAcquire(1, kWaitMs);
+    });
+    QSignalSpy failed(&loader, &ModuleLazyLoader::moduleFailed);
+
+    loader.request("wallet", "app");
+    QTRY_COMPARE(failed.count(), 1);
+
+    // Joins the running load instead of starting another, and gets a new deadline
+    loader.request("wallet", "other");
+    QTest::qWait(50);
+    QCOMPARE(loads.load(), 1);
+    QCOMPARE(failed.count(), 1);
+
+    gate.release();
+    QTRY_COMPARE(failed.count(), 2);
+    QCOMPARE(loads.load(), 1);
+    QVERIFY(!loader.isLoading("wallet"));
+}
+
+QTEST_GUILESS_MAIN(TestModuleLazyLoader)
+#include "tst_modulelazyloader.moc"
@@ -0,0 +1,91 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include "ModuleLeaseManager.h"
+
+class TestModuleLeaseManager : public QObject {
+    Q_OBJECT
+
+private slots:
+    void unloadsAfterGracePeriod();
+    void reacquireDuringGraceKeepsModuleUnpinned();
+    void pinsModulesLoadedElsewhere();
+    void forgetCancelsPendingUnload();
+};
+
+void TestModuleLeaseManager::unloadsAfterGracePeriod()
+{
+    ModuleLeaseManager leases;
+    leases.setGracePeriod(0);
+    QSignalSpy unloads(&leases, &ModuleLeaseManager::unloadRequested);
+
+    leases.acquire("app", {"wallet"}, {});
+    leases.acquire("other", {"wallet"}, {"wallet"});
+    QCOMPARE(leases.leaseCount("wallet"), 2);
+    QVERIFY(!leases.isPinned("wallet"));
+
+    leases.release("app");
+    QVERIFY(!leases.isUnloadPending("wallet"));
+    leases.release("other");
+    QVERIFY(leases.isUnloadPending("wallet"));
+
+    QTRY_COMPARE(unloads.count(), 1);
+    QCOMPARE(unloads.at(0).at(0).toString(), QString("wallet"));
+    QVERIFY(!leases.isUnloadPending("wallet"));
+}
+
+void TestModuleLeaseManager::reacquireDuringGraceKeepsModuleUnpinned()
+{
+    ModuleLeaseManager leases;
+    leases.setGracePeriod(0);
+    QSignalSpy unloads(&leases, &ModuleLeaseManager::unloadRequested);
+
+    leases.acquire("app", {"wallet"}, {});
+    leases.release("app");
+    QVERIFY(leases.isUnloadPending("wallet"));
+
+    // Reopened before the grace period ran out; the module is still loaded
+    leases.acquire("app", {"wallet"}, {"wallet"});
+    QVERIFY(!leases.isUnloadPending("wallet"));
+    QVERIFY(!leases.isPinned("wallet"));
+    QTest::qWait(20);
+    QCOMPARE(unloads.count(), 0);
+
+    leases.release("app");
+    QTRY_COMPARE(unloads.count(), 1);
+}
+
+void TestModuleLeaseManager::pinsModulesLoadedElsewhere()
+{
+    ModuleLeaseManager leases;
+    leases.setGracePeriod(0);
+    QSignalSpy unloads(&leases, &ModuleLeaseManager::unloadRequested);
+
+    leases.acquire("app", {"chat"}, {"chat"});
+    QVERIFY(leases.isPinned("chat"));
+    leases.release("app");
+    QVERIFY(!leases.isUnloadPending("chat"));
+    QTest::qWait(20);
+    QCOMPARE(unloads.count(), 0);
+}
+
+void TestModuleLeaseManager::forgetCancelsPendingUnload()
+{
+    ModuleLeaseManager leases;
+    leases.setGracePeriod(0);
+    QSignalSpy unloads(&leases, &ModuleLeaseManager::unloadRequested);
+
+    leases.acquire("app", {"wallet"}, {});
+    leases.release("app");
+    leases.forget("wallet");
+    QVERIFY(!leases.isUnloadPending("wallet"));
+    QTest::qWait(20);
+    QCOMPARE(unloads.count(), 0);
+
+    // Unloaded from outside, so loaded again by someone else: pinned, not ours
+    leases.acquire("app", {"wallet"}, {"wallet"});
+    QVERIFY(leases.isPinned("wallet"));
+}
+
+QTEST_GUILESS_MAIN(TestModuleLeaseManager)
+#include "tst_moduleleasemanager.moc"
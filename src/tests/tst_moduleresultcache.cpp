@@ -0,0 +1,141 @@
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTest>
+
+#include "ModuleCallPolicy.h"
+#include "ModuleResultCache.h"
+
+class TestModuleResultCache : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void reusesResultsUntilExpired();
+    void eventDropsListedMethodsOnly();
+    void dropsResultsOfCallsOverlappingEvent();
+    void cachesNothingUntilSubscribed();
+    void forgetDropsResultsAndSubscription();
+
+private:
+    ModuleCallPolicy m_policy;
+};
+
+void TestModuleResultCache::init()
+{
+    m_policy.load(QJsonDocument::fromJson(R"({
+        "wallet": {
+            "getBalance": { "cacheTtlMs": 60000, "invalidatedBy": ["balanceChanged"] },
+            "getAddress": { "cacheTtlMs": 60000, "invalidatedBy": ["accountChanged"] },
+            "getRate": { "cacheTtlMs": 50 }
+        }
+    })").object());
+}
+
+void TestModuleResultCache::reusesResultsUntilExpired()
+{
+    ModuleResultCache cache(nullptr, &m_policy);
+    cache.setSubscriber([](const QString&, const QStringList&) { return true; });
+    QVERIFY(cache.isCacheable("wallet", "getRate"));
+    QVERIFY(!cache.isCacheable("wallet", "send"));
+
+    QVariant result;
+    QVERIFY(!cache.lookup("wallet", "getRate", {"eur"}, &result));
+    cache.store("wallet", "getRate", {"eur"}, 42, cache.generation("wallet"));
+    QVERIFY(cache.lookup("wallet", "getRate", {"eur"}, &result));
+    QCOMPARE(result.toInt(), 42);
+    // Other arguments are another result
+    QVERIFY(!cache.lookup("wallet", "getRate", {"usd"}, &result));
+
+    QTest::qWait(80);
+    QVERIFY(!cache.lookup("wallet", "getRate", {"eur"}, &result));
+    QCOMPARE(cache.stats("wallet").value("hits").toULongLong(), quint64(1));
+    QCOMPARE(cache.stats("wallet").value("misses").toULongLong(), quint64(3));
+}
+
+void TestModuleResultCache::eventDropsListedMethodsOnly()
+{
+    ModuleResultCache cache(nullptr, &m_policy);
+    QStringList subscribed;
+    QStringList subscribedEvents;
+    cache.setSubscriber([&](const QString& module, const QStringList& events) {
+        subscribed << module;
+        subscribedEvents = events;
+        return true;
+    });
+
+    QVariant result;
+    cache.lookup("wallet", "getBalance", {}, &result);
+    cache.store("wallet", "getBalance", {}, 10, cache.generation("wallet"));
+    cache.store("wallet", "getAddress", {}, "addr", cache.generation("wallet"));
+    QCOMPARE(subscribed, QStringList{"wallet"});
+    subscribedEvents.sort();
+    QCOMPARE(subscribedEvents, (QStringList{"accountChanged", "balanceChanged"}));
+
+    cache.invalidate("wallet", "balanceChanged");
+    QVERIFY(!cache.lookup("wallet", "getBalance", {}, &result));
+    QVERIFY(cache.lookup("wallet", "getAddress", {}, &result));
+    QCOMPARE(result.toString(), QString("addr"));
+    QCOMPARE(subscribed, QStringList{"wallet"});
+}
+
+void TestModuleResultCache::dropsResultsOfCallsOverlappingEvent()
+{
+    ModuleResultCache cache(nullptr, &m_policy);
+    cache.setSubscriber([](const QString&, const QStringList&) { return true; });
+
+    QVariant result;
+    QVERIFY(!cache.lookup("wallet", "getBalance", {}, &result));
+    const quint64 generation = cache.generation("wallet");
+    // The balance changed while the call was running
+    cache.invalidate("wallet", "balanceChanged");
+    cache.store("wallet", "getBalance", {}, 10, generation);
+    QVERIFY(!cache.lookup("wallet", "getBalance", {}, &result));
+
+    // A call started after the event is stored
+    cache.store("wallet", "getBalance", {}, 20, cache.generation("wallet"));
+    QVERIFY(cache.lookup("wallet", "getBalance", {}, &result));
+    QCOMPARE(result.toInt(), 20);
+}
+
+void TestModuleResultCache::cachesNothingUntilSubscribed()
+{
+    ModuleResultCache cache(nullptr, &m_policy);
+    bool connected = false;
+    cache.setSubscriber([&](const QString&, const QStringList&) { return connected; });
+
+    QVariant result;
+    QVERIFY(!cache.lookup("wallet", "getBalance", {}, &result));
+    cache.store("wallet", "getBalance", {}, 10, cache.generation("wallet"));
+    QVERIFY(!cache.lookup("wallet", "getBalance", {}, &result));
+    QCOMPARE(cache.stats("wallet").value("misses").toULongLong(), quint64(0));
+
+    connected = true;
+    QVERIFY(!cache.lookup("wallet", "getBalance", {}, &result));
+    cache.store("wallet", "getBalance", {}, 10, cache.generation("wallet"));
+    QVERIFY(cache.lookup("wallet", "getBalance", {}, &result));
+}
+
+void TestModuleResultCache::forgetDropsResultsAndSubscription()
+{
+    ModuleResultCache cache(nullptr, &m_policy);
+    int subscriptions = 0;
+    cache.setSubscriber([&](const QString&, const QStringList&) {
+        ++subscriptions;
+        return true;
+    });
+
+    QVariant result;
+    cache.lookup("wallet", "getAddress", {}, &result);
+    const quint64 generation = cache.generation("wallet");
+    cache.store("wallet", "getAddress", {}, "addr", generation);
+    cache.forget("wallet");
+    QVERIFY(cache.generation("wallet") != generation);
+
+    // The reloaded module is subscribed to again
+    QVERIFY(!cache.lookup("wallet", "getAddress", {}, &result));
+    QCOMPARE(subscriptions, 2);
+}
+
+QTEST_GUILESS_MAIN(TestModuleResultCache)
+#include "tst_moduleresultcache.moc"
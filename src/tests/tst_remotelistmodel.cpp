@@ -0,0 +1,155 @@
+#include <QSignalSpy>
+#include <QTest>
+#include <QVariantMap>
+#include <functional>
+
+#include "RemoteListModel.h"
+
+class TestRemoteListModel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void pagesThroughCursor();
+    void reloadDropsStaleReply();
+    void errorStopsPaging();
+    void acceptsJsonTextPages();
+
+private:
+    struct Request {
+        QVariantList args;
+        std::function<void(const QVariant&, const QString&)> done;
+
+        QVariantMap page() const { return args.last().toMap(); }
+    };
+
+    // Answers are given by the test through the recorded requests
+    void setUp(RemoteListModel& model, QList<Request>* requests)
+    {
+        model.setFetcher([requests](const QString&, const QString&, const QVariantList& args,
+                                    std::function<void(const QVariant&, const QString&)> done) {
+            requests->append({args, std::move(done)});
+        });
+        model.setPageSize(2);
+        model.setModule("wallet");
+        model.setMethod("listTransactions");
+        model.setArgs({"acct"});
+    }
+
+    static QVariantMap page(const QVariantList& items, const QVariant& nextCursor = QVariant())
+    {
+        QVariantMap result;
+        result["items"] = items;
+        if (nextCursor.isValid()) {
+            result["nextCursor"] = nextCursor;
+        }
+        return result;
+    }
+
+    static QVariantMap item(int id)
+    {
+        return QVariantMap{{"id", id}};
+    }
+
+    static int role(const RemoteListModel& model, const QByteArray& name)
+    {
+        return model.roleNames().key(name, -1);
+    }
+};
+
+void TestRemoteListModel::pagesThroughCursor()
+{
+    RemoteListModel model;
+    QList<Request> requests;
+    setUp(model, &requests);
+
+    // The property changes above make a single request
+    QTRY_COMPARE(requests.size(), 1);
+    QTest::qWait(10);
+    QCOMPARE(requests.size(), 1);
+    QVERIFY(model.isLoading());
+    QCOMPARE(requests[0].args.first().toString(), QString("acct"));
+    QVERIFY(!requests[0].page().value("cursor").isValid());
+    QCOMPARE(requests[0].page().value("limit").toInt(), 2);
+    // Nothing more is fetched while a page is on its way
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+
+    requests[0].done(page({item(1), item(2)}, "c2"), QString());
+    QCOMPARE(model.count(), 2);
+    QVERIFY(model.hasMore());
+    QVERIFY(!model.isLoading());
+    QVERIFY(role(model, "id") > 0);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+
+    model.fetchMore(QModelIndex());
+    QCOMPARE(requests.size(), 2);
+    QCOMPARE(requests[1].page().value("cursor").toString(), QString("c2"));
+
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    requests[1].done(page({item(3)}), QString());
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(model.count(), 3);
+    QVERIFY(!model.hasMore());
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    QCOMPARE(model.data(model.index(2), role(model, "id")).toInt(), 3);
+    QCOMPARE(model.get(0).toMap().value("id").toInt(), 1);
+}
+
+void TestRemoteListModel::reloadDropsStaleReply()
+{
+    RemoteListModel model;
+    QList<Request> requests;
+    setUp(model, &requests);
+    QTRY_COMPARE(requests.size(), 1);
+
+    model.setArgs({"other"});
+    QTRY_COMPARE(requests.size(), 2);
+    QCOMPARE(requests[1].args.first().toString(), QString("other"));
+
+    requests[0].done(page({item(1)}, "c2"), QString());
+    QCOMPARE(model.count(), 0);
+    QVERIFY(model.isLoading());
+
+    requests[1].done(page({item(7)}), QString());
+    QCOMPARE(model.count(), 1);
+    QCOMPARE(model.get(0).toMap().value("id").toInt(), 7);
+}
+
+void TestRemoteListModel::errorStopsPaging()
+{
+    RemoteListModel model;
+    QList<Request> requests;
+    setUp(model, &requests);
+    QTRY_COMPARE(requests.size(), 1);
+
+    requests[0].done(page({item(1), item(2)}, "c2"), QString());
+    model.fetchMore(QModelIndex());
+    QCOMPARE(requests.size(), 2);
+    requests[1].done(QVariant(), "Call timed out");
+    QCOMPARE(model.error(), QString("Call timed out"));
+    QCOMPARE(model.count(), 2);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+
+    // A page without items is a malformed answer, not the end of the list
+    model.reload();
+    QCOMPARE(requests.size(), 3);
+    QVERIFY(model.error().isEmpty());
+    QCOMPARE(model.count(), 0);
+    requests[2].done(QVariantMap{{"nextCursor", "c2"}}, QString());
+    QVERIFY(!model.error().isEmpty());
+}
+
+void TestRemoteListModel::acceptsJsonTextPages()
+{
+    RemoteListModel model;
+    QList<Request> requests;
+    setUp(model, &requests);
+    QTRY_COMPARE(requests.size(), 1);
+
+    requests[0].done(QString(R"({"items": [{"id": 1, "memo": "rent"}], "nextCursor": null})"), QString());
+    QCOMPARE(model.count(), 1);
+    QVERIFY(!model.hasMore());
+    QCOMPARE(model.data(model.index(0), role(model, "memo")).toString(), QString("rent"));
+}
+
+QTEST_GUILESS_MAIN(TestRemoteListModel)
+#include "tst_remotelistmodel.moc"
@@ -0,0 +1,266 @@
+#include <QCoreApplication>
+#include <QTest>
+
+#include "SharedBlobStore.h"
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+class TestSharedBlobStore : public QObject {
+    Q_OBJECT
+
+private slots:
+    void recognizesHandles();
+    void rejectsInvalidHandles();
+#ifdef Q_OS_UNIX
+    void rejectsOtherModulesShm();
+    void copiesShmBlob();
+    void rejectsShmSmallerThanHandle();
+    void rejectsRawImageOutsideBlob();
+#endif
+#ifdef Q_OS_LINUX
+    void rejectsMemfdOfOtherProcess();
+    void mapsOnlySealedMemfd();
+#endif
+
+private:
+    static QVariantMap handle(const QVariantMap& blob) { return QVariantMap{{"$blob", blob}}; }
+
+#ifdef Q_OS_UNIX
+    // A shm object of size bytes filled with fill; unlinked by the caller
+    static QString createShm(const QString& module, qint64 size, char fill)
+    {
+        const QString name = QString("/logos-%1-test-%2").arg(module).arg(QCoreApplication::applicationPid());
+        const int fd = shm_open(name.toUtf8().constData(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (fd < 0) {
+            return QString();
+        }
+        const QByteArray bytes(size, fill);
+        const bool written = ftruncate(fd, size) == 0 && pwrite(fd, bytes.constData(), size, 0) == size;
+        ::close(fd);
+        return written ? name : QString();
+    }
+#endif
+};
+
+void TestSharedBlobStore::recognizesHandles()
+{
+    QVERIFY(SharedBlobStore::isHandle(handle({{"shm", "/logos-wallet-1"}, {"size", 1}})));
+    QVERIFY(!SharedBlobStore::isHandle(QVariantMap{{"$blob", "/logos-wallet-1"}}));
+    QVERIFY(!SharedBlobStore::isHandle(QVariantMap{{"$blob", QVariantMap()}, {"other", 1}}));
+    QVERIFY(!SharedBlobStore::isHandle(QString("$blob")));
+}
+
+void TestSharedBlobStore::rejectsInvalidHandles()
+{
+    SharedBlobStore store;
+    QString error;
+    QVERIFY(store.map("wallet", handle({{"shm", "/logos-wallet-1"}, {"size", 0}}), &error).isEmpty());
+    QCOMPARE(error, QString("Invalid blob size"));
+#ifdef Q_OS_UNIX
+    QVERIFY(store.map("wallet", handle({{"shm", "/logos-wallet-../x"}, {"size", 1}}), &error).isEmpty());
+    QCOMPARE(error, QString("Invalid shared memory name"));
+    QVERIFY(store.map("wallet", handle({{"path", "/etc/passwd"}, {"size", 1}}), &error).isEmpty());
+    QCOMPARE(error, QString("Unsupported blob handle"));
+#endif
+    QCOMPARE(store.count(), 0);
+}
+
+#ifdef Q_OS_UNIX
+void TestSharedBlobStore::rejectsOtherModulesShm()
+{
+    const QString name = createShm("chat", 16, 'c');
+    QVERIFY(!name.isEmpty());
+
+    SharedBlobStore store;
+    QString error;
+    QVERIFY(store.map("wallet", handle({{"shm", name}, {"size", 16}}), &error).isEmpty());
+    QCOMPARE(error, QString("Shared memory name must start with /logos-wallet-"));
+    // Nor a module whose name is a prefix of the owner's
+    QVERIFY(store.map("cha", handle({{"shm", name}, {"size", 16}}), &error).isEmpty());
+    shm_unlink(name.toUtf8().constData());
+}
+
+void TestSharedBlobStore::copiesShmBlob()
+{
+    const QString name = createShm("wallet", 4096, 'a');
+    QVERIFY(!name.isEmpty());
+
+    SharedBlobStore store;
+    QString error;
+    const QString id = store.map("wallet", handle({{"shm", name}, {"size", 4096}, {"mime", "application/octet-stream"}}), &error);
+    QVERIFY2(!id.isEmpty(), qPrintable(error));
+    QCOMPARE(store.count(), 1);
+    QCOMPARE(store.mappedBytes(), qint64(4096));
+
+    // The producer may change or shrink the object afterwards without affecting us
+    const int fd = shm_open(name.toUtf8().constData(), O_RDWR, 0);
+    QVERIFY(fd >= 0);
+    QCOMPARE(pwrite(fd, "b", 1, 0), ssize_t(1));
+    QCOMPARE(ftruncate(fd, 0), 0);
+    ::close(fd);
+    shm_unlink(name.toUtf8().constData());
+
+    const std::shared_ptr<const SharedBlobStore::Blob> blob = store.lookup(id);
+    QVERIFY(blob);
+    QCOMPARE(blob->size, qint64(4096));
+    QCOMPARE(char(blob->data[0]), 'a');
+    QCOMPARE(char(blob->data[4095]), 'a');
+
+    store.release(id);
+    QCOMPARE(store.count(), 0);
+    // Still readable by whoever holds it
+    QCOMPARE(char(blob->data[0]), 'a');
+}
+
+void TestSharedBlobStore::rejectsShmSmallerThanHandle()
+{
+    const QString name = createShm("wallet", 16, 'a');
+    QVERIFY(!name.isEmpty());
+
+    SharedBlobStore store;
+    QString error;
+    QVERIFY(store.map("wallet", handle({{"shm", name}, {"size", 4096}}), &error).isEmpty());
+    QCOMPARE(error, QString("Blob is smaller than its handle says"));
+    shm_unlink(name.toUtf8().constData());
+}
+
+void TestSharedBlobStore::rejectsRawImageOutsideBlob()
+{
+    const QString name = createShm("wallet", 64, 'a');
+    QVERIFY(!name.isEmpty());
+
+    SharedBlobStore store;
+    QString error;
+    QVariantMap blob{{"shm", name}, {"size", 64}, {"mime", "image/x-raw"}, {"format", "rgba8888"},
+                     {"width", 4}, {"height", 4}, {"stride", 16}};
+    QVERIFY2(!store.map("wallet", handle(blob), &error).isEmpty(), qPrintable(error));
+
+    // Rows shorter than the pixels they hold
+    blob["stride"] = 8;
+    QVERIFY(store.map("wallet", handle(blob), &error).isEmpty());
+    QCOMPARE(error, QString("Invalid raw image layout"));
+    // More rows than the blob holds
+    blob["stride"] = 16;
+    blob["height"] = 5;
+    QVERIFY(store.map("wallet", handle(blob), &error).isEmpty());
+    QCOMPARE(error, QString("Invalid raw image layout"));
+    shm_unlink(name.toUtf8().constData());
+}
+#endif
+
+#ifdef Q_OS_LINUX
+namespace {
+
+// A child process holding fd open, standing in for a module's host
+class FdHolder {
+public:
+    explicit FdHolder(int fd)
+        : m_fd(fd)
+        , m_pid(fork())
+    {
+        if (m_pid == 0) {
+            for (;;) {
+                pause();
+            }
+        }
+    }
+    ~FdHolder()
+    {
+        if (m_pid > 0) {
+            kill(m_pid, SIGKILL);
+            waitpid(m_pid, nullptr, 0);
+        }
+        ::close(m_fd);
+    }
+    qint64 pid() const { return m_pid; }
+    int fd() const { return m_fd; }
+
+private:
+    int m_fd;
+    pid_t m_pid;
+};
+
+int createMemfd(qint64 size, bool sealed)
+{
+    const int fd = memfd_create("logos-test", MFD_ALLOW_SEALING);
+    if (fd < 0 || ftruncate(fd, size) != 0) {
+        return -1;
+    }
+    if (sealed && fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+}
+
+void TestSharedBlobStore::rejectsMemfdOfOtherProcess()
+{
+    const int fd = createMemfd(4096, true);
+    QVERIFY(fd >= 0);
+    FdHolder holder(fd);
+    QVERIFY(holder.pid() > 0);
+
+    SharedBlobStore store;
+    QString error;
+    // Our own descriptors are never handed out
+    QVERIFY(store.map("wallet", handle({{"pid", QCoreApplication::applicationPid()}, {"fd", fd}, {"size", 4096}}), &error).isEmpty());
+    QCOMPARE(error, QString("Invalid memfd handle"));
+
+    // Before logos_core reported the module's process, and for another module's
+    const QVariantMap blob{{"pid", holder.pid()}, {"fd", fd}, {"size", 4096}};
+    QVERIFY(store.map("wallet", handle(blob), &error).isEmpty());
+    QCOMPARE(error, QString("memfd does not belong to wallet"));
+    store.setModulePids({{"chat", holder.pid()}});
+    QVERIFY(store.map("wallet", handle(blob), &error).isEmpty());
+    QCOMPARE(error, QString("memfd does not belong to wallet"));
+
+    store.setModulePids({{"wallet", holder.pid()}});
+    QVERIFY2(!store.map("wallet", handle(blob), &error).isEmpty(), qPrintable(error));
+    store.forgetModule("wallet");
+    QVERIFY(store.map("wallet", handle(blob), &error).isEmpty());
+}
+
+void TestSharedBlobStore::mapsOnlySealedMemfd()
+{
+    const int unsealed = createMemfd(4096, false);
+    QVERIFY(unsealed >= 0);
+    FdHolder unsealedHolder(unsealed);
+    QVERIFY(unsealedHolder.pid() > 0);
+
+    SharedBlobStore store;
+    QString error;
+    store.setModulePids({{"wallet", unsealedHolder.pid()}});
+    QVERIFY(store.map("wallet", handle({{"pid", unsealedHolder.pid()}, {"fd", unsealed}, {"size", 4096}}), &error).isEmpty());
+    QCOMPARE(error, QString("memfd is not sealed against shrinking"));
+
+    const int sealed = createMemfd(4096, true);
+    QVERIFY(sealed >= 0);
+    QCOMPARE(pwrite(sealed, "x", 1, 0), ssize_t(1));
+    FdHolder sealedHolder(sealed);
+    QVERIFY(sealedHolder.pid() > 0);
+    store.setModulePids({{"wallet", sealedHolder.pid()}});
+
+    // Mapped, not copied: later writes by the producer are visible
+    const QString id = store.map("wallet", handle({{"pid", sealedHolder.pid()}, {"fd", sealed}, {"size", 4096}}), &error);
+    QVERIFY2(!id.isEmpty(), qPrintable(error));
+    const std::shared_ptr<const SharedBlobStore::Blob> blob = store.lookup(id);
+    QCOMPARE(char(blob->data[0]), 'x');
+    QCOMPARE(pwrite(sealed, "y", 1, 0), ssize_t(1));
+    QCOMPARE(char(blob->data[0]), 'y');
+
+    // Larger than the memfd
+    QVERIFY(store.map("wallet", handle({{"pid", sealedHolder.pid()}, {"fd", sealed}, {"size", 8192}}), &error).isEmpty());
+    QCOMPARE(error, QString("Blob is smaller than its handle says"));
+}
+#endif
+
+QTEST_GUILESS_MAIN(TestSharedBlobStore)
+#include "tst_sharedblobstore.moc"